@@ -33,6 +33,16 @@
 namespace S2Core {
 	enum class GBACastFeeling : uint8_t { Neutral, Friendly, Angry, Love, Invalid };
 
+	/* All Casts of a Slot, one array per value. See GBASlot::ReadCasts(). */
+	struct GBACastTable {
+		static constexpr uint8_t Count = 26;
+
+		uint8_t Friendly[Count] = { }, Romance[Count] = { }, Intimidate[Count] = { };
+		GBACastFeeling Feeling[Count] = { };
+		uint8_t FeelingEffectHours[Count] = { };
+		bool RegisteredOnPhone[Count] = { }, Secret[Count] = { };
+	};
+
 	class GBACast {
 	public:
 		GBACast(const uint32_t Offs, const uint8_t Cast)
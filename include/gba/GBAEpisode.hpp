@@ -31,6 +31,14 @@
 
 
 namespace S2Core {
+	/* All Episodes of a Slot, one array per value. See GBASlot::ReadEpisodes(). */
+	struct GBAEpisodeTable {
+		static constexpr uint8_t Count = 11;
+
+		uint8_t Rating[4][Count] = { }; // Category, Episode.
+		bool State[Count] = { };
+	};
+
 	class GBAEpisode {
 	public:
 		GBAEpisode(const uint8_t Slot, const uint8_t Episode, const uint8_t Move = 0x0)
@@ -43,6 +51,8 @@ namespace S2Core {
 		bool State() const;
 		void State(const bool V);
 	private:
+		friend class GBASlot; // For the bulk access through GBASlot::ReadEpisodes().
+
 		uint8_t Episode = 0;
 		uint32_t Offs = 0;
 
@@ -0,0 +1,110 @@
+/*
+*   This file is part of Sim2Editor-CPPCore
+*   Copyright (C) 2020-2021 Sim2Team
+*
+*   This program is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Additional Terms 7.b and 7.c of GPLv3 apply to this file:
+*       * Requiring preservation of specified reasonable legal notices or
+*         author attributions in that material or in the Appropriate Legal
+*         Notices displayed by works containing it.
+*       * Prohibiting misrepresentation of the origin of that material,
+*         or requiring that modified versions of such material be marked in
+*         reasonable ways as different from the original version.
+*/
+
+#ifndef _SIM2EDITOR_CPP_CORE_GBA_HOUSE_GRID_HPP
+#define _SIM2EDITOR_CPP_CORE_GBA_HOUSE_GRID_HPP
+
+#include "GBAHouseItem.hpp"
+#include "../shared/CoreCommon.hpp"
+
+
+/*
+	NOTE:
+		The tile size of the items isn't researched yet, so no footprints are shipped and every item takes a single tile until told otherwise through SetFootprint().
+		The occupancy of such items is only a guess, so Collides() and FirstFree() refuse to answer while one is involved (see KnownFootprint() and GetUnknown()).
+		The footprint is given for the Right / Left direction, Down and Up swap width and height.
+		The default room size of 16x16 tiles isn't verified either, pass the real one to the constructor once known.
+*/
+namespace S2Core {
+	/* The size of an Item in tiles. */
+	struct GBAItemFootprint {
+		uint8_t Width = 1;
+		uint8_t Height = 1;
+		bool Known = false; // False, if the 1x1 default is used, because the size wasn't set through GBAHouseGrid::SetFootprint().
+	};
+
+	/*
+		A tile occupancy grid of a room, built from the House Item list.
+
+		Each row is kept as a bitmask, so checking a tile is a single bit test,
+		and checking or searching a footprint works on whole rows instead of on every Item.
+		The grid doesn't read from the Sav on its own after Build(), so a GBAHouseItem with an attached grid (see GBAHouseItem::Attach())
+		keeps it up to date, or the Place / Move / Remove calls can be used directly, for example to try out layouts.
+	*/
+	class GBAHouseGrid {
+	public:
+		GBAHouseGrid(const uint8_t Width = 0x10, const uint8_t Height = 0x10);
+
+		/* Build from the SavBuffer (respects SavSnapshot pins) or from any Buffer, for walking many Houses without loading them. */
+		void Build(const GBAHouseItem &Items);
+		void Build(const uint8_t *Data, const uint32_t ItemOffs);
+		void Clear();
+
+		uint8_t GetWidth() const { return this->Width; };
+		uint8_t GetHeight() const { return this->Height; };
+		uint8_t GetCount() const { return this->Count; };
+		uint8_t GetUnknown() const; // How many placed Items use the 1x1 default footprint.
+
+		bool Free(const uint8_t X, const uint8_t Y) const;
+		int8_t ItemAt(const uint8_t X, const uint8_t Y) const;
+		bool Collides(const uint8_t ID, const uint8_t X, const uint8_t Y, const GBAHouseItemDirection Direction, const int8_t Ignore = -1) const;
+		bool FirstFree(const uint8_t ID, const GBAHouseItemDirection Direction, uint8_t &X, uint8_t &Y) const;
+
+		/* Incremental updates, the Index is the House Item Index. */
+		void Place(const uint8_t Index, const uint8_t ID, const uint8_t X, const uint8_t Y, const GBAHouseItemDirection Direction);
+		void Move(const uint8_t Index, const uint8_t X, const uint8_t Y);
+		void Turn(const uint8_t Index, const GBAHouseItemDirection Direction);
+		void Change(const uint8_t Index, const uint8_t ID);
+		void Remove(const uint8_t Index);
+
+		/* The footprint table, shared by all grids. */
+		static GBAItemFootprint Footprint(const uint8_t ID, const GBAHouseItemDirection Direction);
+		static void SetFootprint(const uint8_t ID, const uint8_t Width, const uint8_t Height);
+		static bool KnownFootprint(const uint8_t ID) { return GBAHouseGrid::Footprints[ID].Known; };
+
+		static constexpr uint8_t MaxSize = 32; // Rows are 32 bit masks.
+		static constexpr uint8_t MaxItems = 12;
+	private:
+		struct Entry {
+			uint8_t ID = 0xE6;
+			uint8_t X = 0, Y = 0;
+			GBAHouseItemDirection Direction = GBAHouseItemDirection::Right;
+		};
+
+		uint8_t Width = 0x10, Height = 0x10, Count = 0;
+		uint32_t Rows[MaxSize] = { };
+		uint8_t Cells[MaxSize][MaxSize] = { }; // How many Items cover a tile, so overlapping Items from the Sav can be removed again.
+		Entry Items[MaxItems];
+
+		void Mark(const Entry &Item, const bool Add);
+		bool Guessed(const uint8_t ID, const int8_t Ignore) const;
+		uint32_t RowMask(const uint8_t X, const uint8_t W) const;
+
+		static GBAItemFootprint Footprints[0x100];
+	};
+};
+
+#endif
\ No newline at end of file
@@ -38,6 +38,7 @@
 */
 namespace S2Core {
 	enum class GBAHouseItemDirection : uint8_t { Right = 0x1, Down = 0x3, Left = 0x5, Up = 0x7, Invalid = 0xFF };
+	class GBAHouseGrid; // Forward declaration.
 
 	class GBAHouseItem {
 	public:
@@ -49,6 +50,7 @@ namespace S2Core {
 
 		uint8_t ID(const uint8_t Index) const;
 		void ID(const uint8_t Index, const uint8_t V);
+		uint8_t IDs(uint8_t *Out) const;
 
 		/* Flag and Use count. */
 		uint8_t Flag(const uint8_t Index) const;
@@ -68,8 +70,14 @@ namespace S2Core {
 		/* Add and Remove. */
 		bool AddItem(const uint8_t ID, const uint8_t Flag, const uint8_t UseCount, const uint8_t XPos, const uint8_t YPos, const GBAHouseItemDirection Direction);
 		bool RemoveItem(const uint8_t Index);
+
+		/* Occupancy grid, only kept in sync with the changes through this instance. */
+		void Attach(GBAHouseGrid *Grid);
 	private:
 		uint32_t Offs = 0;
+		GBAHouseGrid *Grid = nullptr;
+
+		void Sync(const uint8_t Index);
 	};
 };
 
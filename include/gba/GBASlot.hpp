@@ -34,9 +34,19 @@
 #include "GBAMinigame.hpp"
 #include "GBASocialMove.hpp"
 #include "../shared/CoreCommon.hpp"
+#include <vector>
 
 
 namespace S2Core {
+	/* The whole packed Appearance record of a Slot (0x1D - 0x21), for reading and writing in one pass. */
+	struct GBAAppearance {
+		uint8_t Hairstyle = 0, Shirtcolor3 = 0; // 0x1D.
+		uint8_t Tan = 0, Shirtcolor2 = 0; // 0x1E.
+		uint8_t Haircolor = 0, Hatcolor = 0; // 0x1F.
+		uint8_t Shirt = 0, Shirtcolor1 = 0; // 0x20.
+		uint8_t Pants = 0, Pantscolor = 0; // 0x21.
+	};
+
 	class GBASlot {
 	public:
 		GBASlot(const uint8_t Slot)
@@ -73,6 +83,8 @@ namespace S2Core {
 		void Pants(const uint8_t V);
 		uint8_t Pantscolor() const;
 		void Pantscolor(const uint8_t V);
+		GBAAppearance Appearance() const;
+		void Appearance(const GBAAppearance &V);
 
 		/* Skill Points. */
 		uint8_t Confidence() const;
@@ -151,6 +163,18 @@ namespace S2Core {
 		std::unique_ptr<GBASocialMove> SocialMove(const uint8_t Move) const;
 		std::unique_ptr<GBACast> Cast(const uint8_t CST) const;
 
+		/* Bulk access of the above. */
+		bool ReadEpisodes(GBAEpisodeTable &Out) const;
+		void WriteEpisodes(const GBAEpisodeTable &V);
+		bool ReadSocialMoves(GBASocialMoveTable &Out) const;
+		void WriteSocialMoves(const GBASocialMoveTable &V);
+		bool ReadCasts(GBACastTable &Out) const;
+		void WriteCasts(const GBACastTable &V);
+
+		/* Single Slot files, see SavTransfer. */
+		std::vector<uint8_t> Export() const;
+		bool Import(const uint8_t *Data, const size_t Size);
+
 		bool FixChecksum();
 	private:
 		uint8_t Slot = 0;
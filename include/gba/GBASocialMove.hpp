@@ -33,6 +33,14 @@
 namespace S2Core {
 	enum class SocialMoveFlag : uint8_t { Locked = 0x0, Unlocked = 0x1, Blocked = 0x2 };
 
+	/* All Social Moves of a Slot, one array per value. See GBASlot::ReadSocialMoves(). */
+	struct GBASocialMoveTable {
+		static constexpr uint8_t Count = 15;
+
+		SocialMoveFlag Flag[Count] = { };
+		uint8_t Level[Count] = { }, BlockedHours[Count] = { };
+	};
+
 	class GBASocialMove {
 	public:
 		GBASocialMove(const uint32_t Offs, const uint8_t Move)
@@ -47,6 +47,8 @@ namespace S2Core {
 
 		uint8_t Pixel(const uint16_t Idx) const;
 		void Pixel(const uint16_t Idx, const uint8_t V);
+		void ReadPixels(uint8_t *Out) const;
+		void WritePixels(const uint8_t *In);
 		uint8_t PixelPos(const uint8_t X, const uint8_t Y) const;
 		void PixelPos(const uint8_t X, const uint8_t Y, const uint8_t V);
 
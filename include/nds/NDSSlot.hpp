@@ -28,6 +28,7 @@
 #define _SIM2EDITOR_CPP_CORE_NDS_SLOT_HPP
 
 #include "../shared/CoreCommon.hpp"
+#include <vector>
 
 
 namespace S2Core {
@@ -70,6 +71,10 @@ namespace S2Core {
 		uint16_t PocketID(const uint8_t Index) const;
 		void PocketID(const uint8_t Index, const uint16_t V);
 
+		/* Single Slot files, see SavTransfer. */
+		std::vector<uint8_t> Export() const;
+		bool Import(const uint8_t *Data, const size_t Size);
+
 		bool FixChecksum();
 	private:
 		uint8_t Slot = 0;
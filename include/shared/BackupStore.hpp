@@ -0,0 +1,69 @@
+/*
+*   This file is part of Sim2Editor-CPPCore
+*   Copyright (C) 2020-2021 Sim2Team
+*
+*   This program is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Additional Terms 7.b and 7.c of GPLv3 apply to this file:
+*       * Requiring preservation of specified reasonable legal notices or
+*         author attributions in that material or in the Appropriate Legal
+*         Notices displayed by works containing it.
+*       * Prohibiting misrepresentation of the origin of that material,
+*         or requiring that modified versions of such material be marked in
+*         reasonable ways as different from the original version.
+*/
+
+#ifndef _SIM2EDITOR_CPP_CORE_BACKUP_STORE_HPP
+#define _SIM2EDITOR_CPP_CORE_BACKUP_STORE_HPP
+
+#include "CoreCommon.hpp"
+#include <vector>
+
+
+namespace S2Core {
+	/*
+		A content addressed Backup store.
+
+		Savs are split into 0x1000 byte blocks, which are stored once per unique content under 'Blocks/<Hash>', RLE compressed if that is smaller.
+		Each Backup is only a small manifest listing its block hashes, so an unchanged Slot costs nothing on the next Backup.
+
+		Layout: '<BasePath>/Backups/<GBA|NDS>/Sims2-Year.Month.Day-Hour.Minute.Second.S2B' and '<BasePath>/Backups/<GBA|NDS>/Blocks/'.
+
+		Manifest format: 'S2BM', Version (u8), SavType (u8), 2 reserved bytes, Size (u32), Image hash (u64), then a block hash (u64) per block.
+		Block format: Codec (u8, 0 = Raw, 1 = RLE), then the data. All values are little endian.
+	*/
+	class BackupStore {
+	public:
+		BackupStore(const std::string &BasePath)
+			: BasePath(BasePath) { };
+
+		std::string Store(const uint8_t *Data, const uint32_t Size, const SavType Type, const bool Compress = true);
+		std::vector<std::string> List(const SavType Type) const;
+		std::unique_ptr<uint8_t[]> Restore(const std::string &Name, const SavType Type, uint32_t &Size) const;
+		uint32_t Prune(const SavType Type, const uint32_t Keep);
+
+		static constexpr uint32_t BlockSize = 0x1000;
+	private:
+		std::string BasePath = "";
+
+		std::string TypePath(const SavType Type, const bool Create = false) const;
+		bool WriteFile(const std::string &Path, const uint8_t *Data, const size_t Size) const;
+		std::vector<uint8_t> ReadFile(const std::string &Path) const;
+
+		static constexpr uint8_t Magic[4] = { 'S', '2', 'B', 'M' };
+		static constexpr uint8_t Version = 1;
+	};
+};
+
+#endif
\ No newline at end of file
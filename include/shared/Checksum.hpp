@@ -34,6 +34,7 @@
 namespace S2Core {
 	namespace Checksum {
 		uint16_t Calc(const uint8_t *Buffer, const uint16_t StartIndex, const uint16_t EndIndex, const std::vector<uint32_t> &SkipOffs = { });
+		uint64_t Hash(const uint8_t *Buffer, const uint32_t Size);
 	};
 };
 
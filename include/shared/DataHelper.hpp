@@ -32,6 +32,13 @@
 
 namespace S2Core {
 	namespace DataHelper {
+		/* The Sav data is little endian; on little endian hosts, values can be copied as they are. */
+		#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+			static constexpr bool HostLittleEndian = false;
+		#else
+			static constexpr bool HostLittleEndian = true;
+		#endif
+
 		/*
 			Read from a Buffer.
 
@@ -43,7 +50,11 @@ namespace S2Core {
 			if (!Buffer) return 0; // Return 0, if nullptr.
 
 			T Res = 0;
-			memcpy(&Res, Buffer + Offs, sizeof(T));
+			if constexpr (HostLittleEndian) memcpy(&Res, Buffer + Offs, sizeof(T));
+			else {
+				for (size_t Idx = sizeof(T); Idx > 0; Idx--) Res = (T)((Res << 8) | Buffer[Offs + Idx - 1]);
+			}
+
 			return Res;
 		};
 
@@ -60,14 +71,88 @@ namespace S2Core {
 		bool Write(uint8_t *Buffer, const uint32_t Offs, T Data) {
 			if (!Buffer) return false;
 
-			for (size_t Idx = 0; Idx < sizeof(T); Idx++) {
-				Buffer[Offs + Idx] = (uint8_t)Data;
-				Data >>= 8; // Go to next byte.
+			if constexpr (HostLittleEndian) memcpy(Buffer + Offs, &Data, sizeof(T));
+			else {
+				for (size_t Idx = 0; Idx < sizeof(T); Idx++) {
+					Buffer[Offs + Idx] = (uint8_t)Data;
+					Data >>= 8; // Go to next byte.
+				}
+			}
+
+			return true;
+		};
+
+		/*
+			Read an array from a Buffer.
+
+			const uint8_t *Buffer: The Buffer.
+			const uint32_t Offs: The Offset of the first element.
+			T *Out: Where to store the elements.
+			const uint32_t Count: The amount of elements.
+			const uint32_t Stride: The distance between two elements in the Buffer, for elements inside of bigger records.
+			Defaults to sizeof(T) for tightly packed arrays.
+
+			Returns true if success, false if not.
+		*/
+		template <typename T>
+		bool ReadArray(const uint8_t *Buffer, const uint32_t Offs, T *Out, const uint32_t Count, const uint32_t Stride = sizeof(T)) {
+			if (!Buffer || !Out) return false;
+
+			if (HostLittleEndian && Stride == sizeof(T)) memcpy(Out, Buffer + Offs, Count * sizeof(T)); // One copy for the whole array.
+			else {
+				for (uint32_t Idx = 0; Idx < Count; Idx++) Out[Idx] = Read<T>(Buffer, Offs + (Idx * Stride));
 			}
 
 			return true;
 		};
 
+		/*
+			Write an array to a Buffer.
+
+			uint8_t *Buffer: The Buffer.
+			const uint32_t Offs: The Offset of the first element.
+			const T *In: The elements to write.
+			const uint32_t Count: The amount of elements.
+			const uint32_t Stride: The distance between two elements in the Buffer, see ReadArray.
+
+			Returns true if success, false if not.
+		*/
+		template <typename T>
+		bool WriteArray(uint8_t *Buffer, const uint32_t Offs, const T *In, const uint32_t Count, const uint32_t Stride = sizeof(T)) {
+			if (!Buffer || !In) return false;
+
+			if (HostLittleEndian && Stride == sizeof(T)) memcpy(Buffer + Offs, In, Count * sizeof(T));
+			else {
+				for (uint32_t Idx = 0; Idx < Count; Idx++) Write<T>(Buffer, Offs + (Idx * Stride), In[Idx]);
+			}
+
+			return true;
+		};
+
+		/* The amount of bytes an array covers in the Buffer, from the first byte of the first to the last byte of the last element. */
+		template <typename T>
+		constexpr uint32_t ArraySpan(const uint32_t Count, const uint32_t Stride = sizeof(T)) { return (Count ? ((Count - 1) * Stride) + sizeof(T) : 0); };
+
+		/*
+			A packed Bitfield inside a single byte, described at compile time.
+
+			Shift: The lowest bit of the field.
+			Width: The amount of bits the field uses.
+		*/
+		template <uint8_t Shift, uint8_t Width>
+		struct Bitfield {
+			static_assert(Width > 0 && Shift + Width <= 8, "Bitfield must fit into a single byte.");
+
+			static constexpr uint8_t Max = (uint8_t)((1 << Width) - 1);
+			static constexpr uint8_t Mask = (uint8_t)(Max << Shift);
+
+			/* Extract the field from an already loaded byte. */
+			static constexpr uint8_t Get(const uint8_t Byte) { return (Byte & Mask) >> Shift; };
+
+			/* Return the byte with the field replaced; bits outside of the field stay untouched. */
+			static constexpr uint8_t Set(const uint8_t Byte, const uint8_t V) { return (uint8_t)((Byte & ~Mask) | ((V << Shift) & Mask)); };
+		};
+
 		/* BIT stuff. */
 		const bool ReadBit(const uint8_t *Buffer, const uint32_t Offs, const uint8_t BitIndex);
 		bool WriteBit(uint8_t *Buffer, const uint32_t Offs, const uint8_t BitIndex, const bool IsSet);
@@ -75,8 +160,8 @@ namespace S2Core {
 		bool WriteBits(uint8_t *Buffer, const uint32_t Offs, const bool First = true, const uint8_t Data = 0x0);
 
 		/* String stuff. */
-		const std::string ReadString(const uint8_t *Buffer, const uint32_t Offs, const uint32_t Length);
-		bool WriteString(uint8_t *Buffer, const uint32_t Offs, const uint32_t Length, const std::string &Str);
+		const std::string ReadString(const uint8_t *Buffer, const uint32_t Offs, const uint32_t Length, const NDSSavRegion Region = NDSSavRegion::Int);
+		bool WriteString(uint8_t *Buffer, const uint32_t Offs, const uint32_t Length, const std::string &Str, const NDSSavRegion Region = NDSSavRegion::Int);
 	};
 };
 
@@ -0,0 +1,83 @@
+/*
+*   This file is part of Sim2Editor-CPPCore
+*   Copyright (C) 2020-2021 Sim2Team
+*
+*   This program is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Additional Terms 7.b and 7.c of GPLv3 apply to this file:
+*       * Requiring preservation of specified reasonable legal notices or
+*         author attributions in that material or in the Appropriate Legal
+*         Notices displayed by works containing it.
+*       * Prohibiting misrepresentation of the origin of that material,
+*         or requiring that modified versions of such material be marked in
+*         reasonable ways as different from the original version.
+*/
+
+#ifndef _SIM2EDITOR_CPP_CORE_JSON_WRITER_HPP
+#define _SIM2EDITOR_CPP_CORE_JSON_WRITER_HPP
+
+#include "CoreCommon.hpp"
+#include <functional>
+
+
+namespace S2Core {
+	/*
+		A small streaming JSON Writer.
+
+		Everything is written into a fixed size buffer, which gets handed to the Sink whenever it's full and on Flush(),
+		so no document is ever built up in memory.
+	*/
+	class JSONWriter {
+	public:
+		/* A Sink gets the written data and returns false on failure. */
+		using Sink = std::function<bool(const char *Data, const size_t Size)>;
+		static Sink StringSink(std::string &Str);
+		static Sink FDSink(const int FD);
+
+		JSONWriter(const Sink &Out) : Out(Out) { };
+		~JSONWriter() { this->Flush(); };
+
+		/* Objects and Arrays. Pass a Key when inside an Object, nullptr when inside an Array. */
+		void BeginObject(const char *Key = nullptr);
+		void EndObject();
+		void BeginArray(const char *Key = nullptr);
+		void EndArray();
+
+		/* Values. */
+		void Number(const char *Key, const uint32_t V);
+		void Bool(const char *Key, const bool V);
+		void String(const char *Key, const char *Str, const size_t Length);
+		void String(const char *Key, const std::string &Str) { this->String(Key, Str.c_str(), Str.size()); };
+		void Hex(const char *Key, const uint8_t *Data, const size_t Length);
+
+		bool Flush();
+		bool Good() const { return this->Ok; };
+	private:
+		Sink Out;
+		char Buffer[0x1000];
+		size_t Pos = 0;
+		bool Ok = true;
+
+		/* One bit per nesting level, set once the first value of that level got written. */
+		uint64_t HasValue = 0;
+		uint8_t Depth = 0;
+
+		void Put(const char C);
+		void Put(const char *Str, const size_t Length);
+		void Key(const char *Key);
+		void Escaped(const char *Str, const size_t Length);
+	};
+};
+
+#endif
\ No newline at end of file
@@ -28,6 +28,10 @@
 #define _SIM2EDITOR_CPP_CORE_SAV_HPP
 
 #include "CoreCommon.hpp"
+#include "SavSnapshot.hpp"
+#include <functional>
+#include <iosfwd>
+#include <vector>
 #include "../gba/GBASettings.hpp"
 #include "../gba/GBASlot.hpp"
 #include "../nds/NDSPainting.hpp"
@@ -35,16 +39,38 @@
 
 
 namespace S2Core {
+	/* How the Sav data is stored inside the file, see SAV::InitContainer(). */
+	enum class SavContainer : uint8_t { Raw, DeSmuME, Padded };
+
+	/* A pull style reader: Fill up to Size bytes into Buffer and return how many, 0 on the end or on errors. */
+	using SavReader = std::function<size_t(uint8_t *Buffer, const size_t Size)>;
+
 	class SAV {
 	public:
 		SAV(const std::string &SavFile);
 		SAV(std::unique_ptr<uint8_t[]> &Data, const uint32_t Size);
+		SAV(uint8_t *Data, const uint32_t Size);
+		SAV(const uint8_t *Data, const uint32_t Size);
+		SAV(const SavReader &Reader, const uint32_t SizeHint = 0);
+		SAV(std::istream &Stream);
 
 		void ValidationCheck();
 		bool SlotExist(const uint8_t Slot) const;
 		void SetChangesMade(const bool V) { this->ChangesMade = V; };
 		void Finish();
 
+		/* Snapshot stuff. */
+		void Publish();
+		std::shared_ptr<const SavEpoch> CurrentEpoch() const { return std::atomic_load(&this->Epoch); };
+
+		/* Dirty tracking, in DirtyGranule sized chunks. Dirty means not yet written to disk. */
+		void MarkDirty(const uint32_t Offs, const uint32_t Size);
+		bool Dirty(const uint32_t Offs, const uint32_t Size) const;
+		std::vector<std::pair<uint32_t, uint32_t>> DirtyRanges() const;
+		void ClearDirty() { this->DirtyMap.clear(); };
+		void ClearDirty(const uint32_t Offs, const uint32_t Size);
+		static constexpr uint32_t DirtyGranule = 0x10;
+
 		/* GBA Core returns. */
 		std::unique_ptr<GBASlot> _GBASlot(const uint8_t Slot) const;
 		std::unique_ptr<GBASettings> _GBASettings() const;
@@ -55,21 +81,42 @@ namespace S2Core {
 
 		/* Some basic returns. */
 		uint32_t GetSize() const { return this->SavSize; };
-		uint8_t *GetData() const { return this->SavData.get(); };
+		uint8_t *GetData() const { return this->GetFileData(); }; // The Sav data starts the file for all containers.
 		SavType GetType() const { return this->SType; };
 		bool GetChangesMade() const { return this->ChangesMade; };
 		bool GetValid() const { return this->SavValid; };
+		bool GetReadOnly() const { return this->ReadOnly; };
 		std::string GetPath() const { return this->SavPath; };
 
+		/* Container returns. GetData() / GetSize() are the Sav data, these are the whole file including footers or padding. */
+		SavContainer GetContainer() const { return this->Container; };
+		uint8_t *GetFileData() const { return (this->External ? this->External : this->SavData.get()); };
+		uint32_t GetFileSize() const { return this->FileSize; };
+
 		/* NDS returns. */
 		NDSSavRegion GetRegion() const { return this->Region; };
+		int8_t GetNDSSlot(const uint8_t Slot) const { return (Slot < 3 ? this->NDSSlots[Slot] : -1); };
 	private:
 		/* Some basic vars. */
 		std::unique_ptr<uint8_t[]> SavData = nullptr;
+		uint8_t *External = nullptr; // Caller owned memory, used instead of SavData if set.
 		uint32_t SavSize = 0;
-		bool SavValid = false, ChangesMade = false;
+		bool SavValid = false, ChangesMade = false, ReadOnly = false;
+
+		/* Container stuff. */
+		SavContainer Container = SavContainer::Raw;
+		uint32_t FileSize = 0;
+		void InitContainer(const uint32_t Size);
+		static constexpr uint32_t MaxFileSize = 0x200000; // Bigger files are not even read.
 		std::string SavPath = "";
 
+		/* The latest published Epoch. Only ever accessed through std::atomic_load / std::atomic_store. */
+		std::shared_ptr<const SavEpoch> Epoch = nullptr;
+		uint64_t Generation = 0;
+
+		/* A bit per DirtyGranule, empty if nothing is dirty. */
+		std::vector<uint64_t> DirtyMap;
+
 		/* Savtype & NDS Region. */
 		SavType SType = SavType::_NONE;
 		NDSSavRegion Region = NDSSavRegion::Unknown;
@@ -77,6 +124,7 @@ namespace S2Core {
 		/* NDS only Related things. */
 		int8_t NDSSlots[3] = { -1, -1, -1 };
 		int8_t InitNDSSlotIdxs(const uint8_t SavSlot, const uint8_t Reg);
+		static bool NDSHeader(const uint8_t *Data);
 
 		/* Identifiers to check for Savetypes. */
 		static constexpr uint8_t GBAIdent[0x7] = { 0x53, 0x54, 0x57, 0x4E, 0x30, 0x32, 0x34 };
@@ -0,0 +1,68 @@
+/*
+*   This file is part of Sim2Editor-CPPCore
+*   Copyright (C) 2020-2021 Sim2Team
+*
+*   This program is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Additional Terms 7.b and 7.c of GPLv3 apply to this file:
+*       * Requiring preservation of specified reasonable legal notices or
+*         author attributions in that material or in the Appropriate Legal
+*         Notices displayed by works containing it.
+*       * Prohibiting misrepresentation of the origin of that material,
+*         or requiring that modified versions of such material be marked in
+*         reasonable ways as different from the original version.
+*/
+
+#ifndef _SIM2EDITOR_CPP_CORE_SAV_ATTACH_HPP
+#define _SIM2EDITOR_CPP_CORE_SAV_ATTACH_HPP
+
+#include "Sav.hpp"
+#include "SavLayout.hpp"
+#include <unordered_map>
+
+
+namespace S2Core {
+	/*
+		Attaches a SAV to externally mapped memory, like the backup memory an emulator exposes as a file or a POSIX shared memory object.
+
+		The SAV works directly on the mapping (MAP_SHARED), so it always sees the current state and writes go straight to the other side.
+		Poll() hashes the mapping in 0x1000 byte blocks and returns the Slots / Paintings, which changed since the last Poll().
+
+		To use the GBA* / NDS* classes on it without swapping it into SavUtils::Sav, Publish() it after a Poll() and pin it with a SavSnapshot.
+	*/
+	class SavAttach {
+	public:
+		SavAttach(const std::string &Path, const bool Writable = false, const bool SharedMemory = false);
+		~SavAttach();
+		SavAttach(const SavAttach &) = delete;
+		SavAttach &operator=(const SavAttach &) = delete;
+
+		bool Attached() const { return this->Sav && this->Sav->GetValid(); };
+		SAV *GetSav() const { return this->Sav.get(); };
+		uint64_t GetGeneration() const { return this->Generation; };
+
+		std::vector<SavSectionRef> Poll();
+
+		static constexpr uint32_t BlockSize = 0x1000;
+	private:
+		void *Mapping = nullptr;
+		size_t MapSize = 0;
+		std::unique_ptr<SAV> Sav = nullptr;
+		std::vector<uint64_t> Hashes; // Per block of the mapping.
+		std::unordered_map<uint16_t, uint64_t> SectionHashes; // Per Section, keyed by (Section << 8) | Index.
+		uint64_t Generation = 0; // Increases on every Poll() that found changes.
+	};
+};
+
+#endif
\ No newline at end of file
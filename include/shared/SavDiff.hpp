@@ -0,0 +1,60 @@
+/*
+*   This file is part of Sim2Editor-CPPCore
+*   Copyright (C) 2020-2021 Sim2Team
+*
+*   This program is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Additional Terms 7.b and 7.c of GPLv3 apply to this file:
+*       * Requiring preservation of specified reasonable legal notices or
+*         author attributions in that material or in the Appropriate Legal
+*         Notices displayed by works containing it.
+*       * Prohibiting misrepresentation of the origin of that material,
+*         or requiring that modified versions of such material be marked in
+*         reasonable ways as different from the original version.
+*/
+
+#ifndef _SIM2EDITOR_CPP_CORE_SAV_DIFF_HPP
+#define _SIM2EDITOR_CPP_CORE_SAV_DIFF_HPP
+
+#include "SavLayout.hpp"
+
+
+namespace S2Core {
+	/*
+		A changed Field.
+
+		For String Fields, OldStr and NewStr contain the values, for Raw Fields New contains the amount of changed bytes.
+		If a whole Section only exists in one of both Savs, Path is just the Section (like 'Slot2') and Old / New are 1 or 0.
+	*/
+	struct SavDiffEntry {
+		std::string Path = "";
+		uint32_t OldOffs = 0, NewOffs = 0; // These can differ because of the GBA House Items or the NDS Slot rotation.
+		uint32_t Old = 0, New = 0;
+		std::string OldStr = "", NewStr = "";
+	};
+
+	/*
+		Field level diffing of two Savs of the same type.
+
+		Only Sections whose contents differ are decoded, identical Slots and Paintings are skipped right away.
+		For diffing many Savs against the same baseline, fetch the Hashes() of the baseline once and pass them along.
+	*/
+	namespace SavDiff {
+		std::vector<uint64_t> Hashes(const SAV &Sav);
+		std::vector<SavDiffEntry> Compare(const SAV &Old, const SAV &New);
+		std::vector<SavDiffEntry> Compare(const SAV &Old, const std::vector<uint64_t> &OldHashes, const SAV &New);
+	};
+};
+
+#endif
\ No newline at end of file
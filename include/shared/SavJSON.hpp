@@ -0,0 +1,50 @@
+/*
+*   This file is part of Sim2Editor-CPPCore
+*   Copyright (C) 2020-2021 Sim2Team
+*
+*   This program is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Additional Terms 7.b and 7.c of GPLv3 apply to this file:
+*       * Requiring preservation of specified reasonable legal notices or
+*         author attributions in that material or in the Appropriate Legal
+*         Notices displayed by works containing it.
+*       * Prohibiting misrepresentation of the origin of that material,
+*         or requiring that modified versions of such material be marked in
+*         reasonable ways as different from the original version.
+*/
+
+#ifndef _SIM2EDITOR_CPP_CORE_SAV_JSON_HPP
+#define _SIM2EDITOR_CPP_CORE_SAV_JSON_HPP
+
+#include "JSONWriter.hpp"
+#include "SavLayout.hpp"
+#include "../gba/GBASettings.hpp"
+
+
+namespace S2Core {
+	/*
+		JSON export of all known contents of a Sav, in a single pass over the SavBuffer.
+
+		const uint8_t Slots: Bitmask of the Slots to export (Bit 1 - 4 for GBA, Bit 0 - 2 for NDS).
+		const bool Paintings: If exporting the NDS Paintings as well.
+		const GBALanguage Lang: The language of the resolved names. Only EN and DE are available, everything else falls back to EN.
+	*/
+	namespace SavJSON {
+		bool Export(const SAV &Sav, JSONWriter &Writer, const uint8_t Slots = 0xFF, const bool Paintings = true, const GBALanguage Lang = GBALanguage::EN);
+		bool Export(const SAV &Sav, std::string &Out, const uint8_t Slots = 0xFF, const bool Paintings = true, const GBALanguage Lang = GBALanguage::EN);
+		bool Export(const SAV &Sav, const int FD, const uint8_t Slots = 0xFF, const bool Paintings = true, const GBALanguage Lang = GBALanguage::EN);
+	};
+};
+
+#endif
\ No newline at end of file
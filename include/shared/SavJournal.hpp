@@ -0,0 +1,110 @@
+/*
+*   This file is part of Sim2Editor-CPPCore
+*   Copyright (C) 2020-2021 Sim2Team
+*
+*   This program is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Additional Terms 7.b and 7.c of GPLv3 apply to this file:
+*       * Requiring preservation of specified reasonable legal notices or
+*         author attributions in that material or in the Appropriate Legal
+*         Notices displayed by works containing it.
+*       * Prohibiting misrepresentation of the origin of that material,
+*         or requiring that modified versions of such material be marked in
+*         reasonable ways as different from the original version.
+*/
+
+#ifndef _SIM2EDITOR_CPP_CORE_SAV_JOURNAL_HPP
+#define _SIM2EDITOR_CPP_CORE_SAV_JOURNAL_HPP
+
+#include "CoreCommon.hpp"
+#include <mutex>
+#include <sys/stat.h>
+#include <thread>
+#include <vector>
+
+
+namespace S2Core {
+	class SAV; // Forward declaration.
+
+	/*
+		An append only write-ahead journal next to the SavFile ('<SavFile>.s2j').
+
+		Commit() fixes the Checksums of the changed Sections and appends only the bytes of the SAV, which changed since the last Commit(),
+		so saving costs a few dozen bytes instead of the whole image. Compact() writes the journaled bytes into the SavFile
+		and empties the journal again. Open() replays a journal left over from a crash.
+
+		Journaled bytes are not in the SavFile yet, so they stay dirty until a Compact() (or a SavWriter write) got them there.
+		That way a SavWriter::Write() in Minimal or Rotate mode writes them as well.
+
+		A crash at any point leaves either the old or the new state: transactions with a bad hash (torn appends) are ignored on replay,
+		and as the journal only gets emptied after the SavFile is synced, a torn Compact() gets repaired by replaying again.
+
+		The header holds a hash of the SavFile the journal builds on. If the SavFile got written some other way since
+		(SavUtils::Finish, SavWriter), the journal is out of date and Open() starts it over instead of replaying old edits over newer data.
+		So Open() has to be called right after loading, before any edits. For the same reason, Commit() starts the journal over
+		if the SavFile changed (by mtime, size or inode) since the journal last wrote or looked at it.
+
+		Journal format: 'S2JL', Version (u8), 3 reserved bytes, SavSize (u32), Base hash (u64).
+		Then each transaction: Payload size (u32), Payload hash (u64), Payload of (Offset (u32), Length (u32), bytes) entries.
+		All values are little endian.
+
+		Usage:
+			SavUtils::LoadSav(File);
+			SavJournal Journal(*SavUtils::Sav);
+			Journal.Open();
+			... edit ...
+			Journal.Commit(); // On every autosave.
+			Journal.Compact(true); // Once in a while, or on exit.
+	*/
+	class SavJournal {
+	public:
+		SavJournal(SAV &Sav);
+		~SavJournal();
+		SavJournal(const SavJournal &) = delete;
+		SavJournal &operator=(const SavJournal &) = delete;
+
+		uint32_t Open();
+		bool Commit();
+		bool Compact(const bool Async = false);
+		void Wait();
+
+		bool GetOpen() const { return this->FD != -1; };
+		uint32_t GetSize();
+		std::string GetPath() const { return this->Path; };
+	private:
+		SAV &Sav;
+		std::string Path = "";
+		int FD = -1;
+		uint32_t Size = 0; // The current size of the journal file.
+		std::vector<uint8_t> Shadow; // The SavFile with the journal applied, to find what changed since the last Commit().
+		std::vector<uint8_t> OnDisk; // What the last Compact() left in the SavFile, until Settle() cleaned up the dirty map.
+		struct stat Stamp = { }; // The SavFile, as the journal knows it.
+
+		std::mutex Mutex; // Guards the journal file and Size against the Compact() thread.
+		std::thread Compactor;
+
+		uint32_t Replay(const uint8_t *Data, const uint32_t Length, uint8_t *Out, int SavFD);
+		bool Reset(const uint64_t Base);
+		bool ReadSav(std::vector<uint8_t> &Out) const;
+		bool Stale() const;
+		void Settle();
+		bool DoCompact();
+
+		static constexpr uint8_t Magic[4] = { 'S', '2', 'J', 'L' };
+		static constexpr uint8_t Version = 2;
+		static constexpr uint32_t HeaderSize = 0x14;
+	};
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,125 @@
+/*
+*   This file is part of Sim2Editor-CPPCore
+*   Copyright (C) 2020-2021 Sim2Team
+*
+*   This program is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Additional Terms 7.b and 7.c of GPLv3 apply to this file:
+*       * Requiring preservation of specified reasonable legal notices or
+*         author attributions in that material or in the Appropriate Legal
+*         Notices displayed by works containing it.
+*       * Prohibiting misrepresentation of the origin of that material,
+*         or requiring that modified versions of such material be marked in
+*         reasonable ways as different from the original version.
+*/
+
+#ifndef _SIM2EDITOR_CPP_CORE_SAV_LAYOUT_HPP
+#define _SIM2EDITOR_CPP_CORE_SAV_LAYOUT_HPP
+
+#include "CoreCommon.hpp"
+#include <vector>
+
+
+/*
+	NOTE:
+		This is a table driven description of every known field of the Savs, so that things like diffing, exporting,
+		patching and validating can walk all fields without calling every single getter.
+
+		The offsets are the same ones as used by the GBA* / NDS* classes, so if you change one there, change it here as well.
+*/
+namespace S2Core {
+	class SAV; // Forward declaration.
+
+	/* The Sections a Sav is made of. */
+	enum class SavSection : uint8_t { GBASettings, GBASlot, NDSSlot, NDSPainting };
+
+	/* How a Field is stored. */
+	enum class SavFieldType : uint8_t {
+		U8, U16, U32,
+		U24, // The upper 3 bytes of an uint32_t, like the GBA Simoleons.
+		Bits, // 'Width' bits starting at bit 'Shift' of a single byte.
+		IndexBit, // Bit <Record Index> of a single byte shared by all Records, like the GBA Minigame played flags.
+		String, // 'Width' bytes, 0x0 terminated.
+		Raw // 'Width' bytes of opaque data, like the NDS Painting pixels.
+	};
+
+	struct SavField {
+		const char *Name;
+		uint32_t Offs; // Relative to the Record.
+		SavFieldType Type;
+		uint8_t Shift; // Bits only.
+		uint16_t Width; // Bits: Bit count, String / Raw: Byte count.
+		uint32_t Min, Max; // The legal range.
+		bool ReadOnly = false; // Counts, checksums and such, which are not meant to be set directly.
+		const uint8_t *Values = nullptr; // If set, only those values are legal (next to Min / Max).
+		uint8_t ValueCount = 0;
+		uint32_t Mirror = 0; // If not 0, setting the Field writes the value to that Section offset as well.
+		bool Strict = false; // If true, the setter ignores illegal values instead of clamping them.
+	};
+
+	struct SavRecord {
+		const char *Name; // Empty for the plain fields of a Section.
+		uint32_t Offs; // Offset of the first Record, relative to the Section.
+		uint32_t Stride;
+		uint8_t Count;
+		bool Shifted; // Moves 0x6 bytes per GBA House Item.
+		std::vector<SavField> Fields;
+		const uint32_t *Table = nullptr; // Irregular Record offsets (GBA Episodes), used instead of Offs + Stride.
+		uint32_t CountOffs = 0; // If not 0, the actual Record count is the byte at that offset (GBA House Items).
+		uint32_t TallyOffs = 0; // If not 0, the byte at that offset holds how many Records have a non empty ID (GBA Items, NDS Pockets).
+		uint16_t EmptyID = 0x0;
+	};
+
+	/* A Checksum of a Section. Offsets are relative to the Section, same as for Checksum::Calc(), but not divided by 2. */
+	struct SavChecksum {
+		const char *Name;
+		uint32_t Start, End, Offs;
+		std::vector<uint32_t> Skips;
+	};
+
+	/* A Section of a loaded Sav. */
+	struct SavSectionRef {
+		SavSection Section;
+		uint8_t Index; // The Slot / Painting index as used by the SAV class.
+		uint32_t Offs, Size; // The absolute location inside the SavBuffer.
+	};
+
+	namespace SavLayout {
+		const std::vector<SavRecord> &Records(const SavSection Section);
+		const char *SectionName(const SavSection Section);
+		std::vector<SavSectionRef> Sections(const SAV &Sav);
+		bool Used(const uint8_t *Buffer, const SavSectionRef &Ref);
+
+		uint8_t HouseItems(const uint8_t *Buffer, const SavSectionRef &Ref);
+		uint8_t RecordCount(const uint8_t *Buffer, const SavSectionRef &Ref, const SavRecord &Rec);
+		uint32_t FieldOffs(const SavSectionRef &Ref, const SavRecord &Rec, const SavField &Field, const uint8_t Idx, const uint8_t HouseItems);
+		std::string Path(const SavSectionRef &Ref, const SavRecord &Rec, const SavField &Field, const uint8_t Idx);
+
+		void Tally(uint8_t *Buffer, const SavSectionRef &Ref, const SavRecord &Rec);
+
+		const std::vector<SavChecksum> &Checksums(const SavSection Section);
+		uint16_t CalcChecksum(const uint8_t *Buffer, const SavSectionRef &Ref, const SavChecksum &CHKS);
+		bool FixChecksums(uint8_t *Buffer, const SavSectionRef &Ref);
+		uint32_t FixDirtyChecksums(SAV &Sav);
+
+		uint32_t Read(const uint8_t *Buffer, const uint32_t Offs, const SavField &Field, const uint8_t Idx = 0);
+		void Write(uint8_t *Buffer, const uint32_t Offs, const SavField &Field, const uint32_t V, const uint8_t Idx = 0);
+		bool Legal(const SavField &Field, const uint32_t V);
+		uint32_t Clamp(const SavField &Field, const uint32_t V);
+		bool Numeric(const SavField &Field);
+		uint32_t Size(const SavField &Field);
+	};
+};
+
+#endif
\ No newline at end of file
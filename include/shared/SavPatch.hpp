@@ -0,0 +1,87 @@
+/*
+*   This file is part of Sim2Editor-CPPCore
+*   Copyright (C) 2020-2021 Sim2Team
+*
+*   This program is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Additional Terms 7.b and 7.c of GPLv3 apply to this file:
+*       * Requiring preservation of specified reasonable legal notices or
+*         author attributions in that material or in the Appropriate Legal
+*         Notices displayed by works containing it.
+*       * Prohibiting misrepresentation of the origin of that material,
+*         or requiring that modified versions of such material be marked in
+*         reasonable ways as different from the original version.
+*/
+
+#ifndef _SIM2EDITOR_CPP_CORE_SAV_PATCH_HPP
+#define _SIM2EDITOR_CPP_CORE_SAV_PATCH_HPP
+
+#include "SavLayout.hpp"
+
+
+namespace S2Core {
+	/* A resolved Patch operation. */
+	struct SavPatchOp {
+		SavSection Section;
+		uint8_t Index; // The Slot / Painting index.
+		uint8_t Record, RecordIdx, Field; // Indexes into SavLayout::Records().
+		uint32_t Value = 0;
+		std::string Str = "";
+	};
+
+	/*
+		A set of field path -> value pairs, which can be applied to a Sav in one go.
+
+		Paths are the same as the ones of SavDiff and SavJSON, such as 'Slot1.Simoleons', 'Slot1.Cast3.Friendly' or 'Settings.Language'.
+		They are resolved once when being added, applying then only has to do the House Item shift, clamp and write.
+		Checksums get fixed once at the end of Apply().
+
+		Values are the stored values, as the getters return them and SavDiff reports them, not the arguments of all setters.
+		For example 'Settings.Music' is the raw volume byte (0x0, 0x19, ... 0xFF), not the 0 - 10 index GBASettings::Music(V) takes.
+		Values out of range get clamped, where the setter clamps, and ignored, where the setter ignores them (appearance, volumes,
+		'CurrentEpisode' and House Item 'Direction'). 'MinigameN.Level' doesn't go to the Settings, like GBAMinigame::Level(V) by default.
+
+		The binary format is:
+			'S2PT', Version (u8), SavType (u8), 2 reserved bytes, Operation count (u32).
+			Each Operation: Section, Index, Record, RecordIdx, Field (all u8), then the value as u32 or for strings as length (u8) + bytes.
+			All values are little endian.
+	*/
+	class SavPatch {
+	public:
+		SavPatch(const SavType Type)
+			: Type(Type) { };
+
+		bool Set(const std::string &Path, const uint32_t V);
+		bool Set(const std::string &Path, const std::string &Str);
+		bool LoadJSON(const std::string &JSON);
+		bool LoadBinary(const uint8_t *Data, const size_t Size);
+		std::vector<uint8_t> Binary() const;
+
+		uint32_t Apply(SAV &Sav) const;
+
+		SavType GetType() const { return this->Type; };
+		const std::vector<SavPatchOp> &GetOps() const { return this->Ops; };
+	private:
+		SavType Type = SavType::_NONE;
+		std::vector<SavPatchOp> Ops;
+
+		bool Resolve(const std::string &Path, SavPatchOp &Op) const;
+		bool Valid(const SavPatchOp &Op) const;
+
+		static constexpr uint8_t Magic[4] = { 'S', '2', 'P', 'T' };
+		static constexpr uint8_t Version = 1;
+	};
+};
+
+#endif
\ No newline at end of file
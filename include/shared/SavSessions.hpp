@@ -0,0 +1,104 @@
+/*
+*   This file is part of Sim2Editor-CPPCore
+*   Copyright (C) 2020-2021 Sim2Team
+*
+*   This program is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Additional Terms 7.b and 7.c of GPLv3 apply to this file:
+*       * Requiring preservation of specified reasonable legal notices or
+*         author attributions in that material or in the Appropriate Legal
+*         Notices displayed by works containing it.
+*       * Prohibiting misrepresentation of the origin of that material,
+*         or requiring that modified versions of such material be marked in
+*         reasonable ways as different from the original version.
+*/
+
+#ifndef _SIM2EDITOR_CPP_CORE_SAV_SESSIONS_HPP
+#define _SIM2EDITOR_CPP_CORE_SAV_SESSIONS_HPP
+
+#include "Sav.hpp"
+#include "SavStats.hpp"
+#include "SavWriter.hpp"
+#include <list>
+#include <unordered_map>
+
+
+namespace S2Core {
+	using SavHandle = uint32_t; // 0 is invalid.
+
+	/*
+		Keeps many Savs open by handle, with only the recently used ones loaded.
+
+		Loaded SAVs are kept in LRU order. Once the size of all loaded SavFiles goes above the budget, the least recently used ones get closed,
+		dirty ones are written back first. Closed sessions are forgotten, so their handles become invalid and Open() has to be called again.
+		That way the bookkeeping stays bounded as well, no matter how many distinct Savs get opened.
+
+		Opening a path, which is still loaded and whose mtime did not change, only returns its handle. If it changed on disk, it gets loaded again.
+		If it changed on disk while the session has unwritten changes, that is a conflict: Open() returns 0, Conflict() returns true
+		and Flush() refuses to overwrite the SavFile. Close() then drops the local changes.
+
+		The GBA* / NDS* classes work on SavUtils::Sav, so Activate() swaps a session in there. The active session is never unloaded,
+		if its SavFile changed on disk, Open() loads it again right into SavUtils::Sav. Activate() refuses to replace a SAV,
+		which got into SavUtils::Sav some other way.
+
+		Each session has its own SavStats::Sink. While a session is active, its Sink is bound to the thread which called Activate(),
+		and loading or flushing a session counts to its Sink as well. Stats() returns them, without touching the process wide counters.
+
+		NOTE: Not thread safe, SAV pointers returned by Get() are only valid until the next call.
+	*/
+	class SavSessions {
+	public:
+		SavSessions(const size_t Budget)
+			: Budget(Budget) { };
+		~SavSessions();
+
+		SavHandle Open(const std::string &Path);
+		SAV *Get(const SavHandle Handle);
+		bool Activate(const SavHandle Handle);
+		bool Flush(const SavHandle Handle, const SavWriteMode Mode = SavWriteMode::Minimal);
+		bool Close(const SavHandle Handle);
+		bool Conflict(const SavHandle Handle) const;
+		SavStatsData Stats(const SavHandle Handle, const bool Clear = false);
+
+		size_t GetUsed() const { return this->Used; };
+		size_t GetLoaded() const { return this->LRU.size(); };
+		size_t GetBudget() const { return this->Budget; };
+		void SetBudget(const size_t Budget);
+	private:
+		struct Session {
+			std::string Path = "";
+			std::unique_ptr<SAV> Sav = nullptr; // nullptr if unloaded or active.
+			int64_t MTime = 0; // In nanoseconds.
+			std::list<SavHandle>::iterator Pos; // Inside LRU, if loaded.
+			bool Loaded = false;
+			SavStats::Sink Stats;
+		};
+
+		size_t Budget = 0, Used = 0;
+		SavHandle Next = 1, Active = 0;
+		const SAV *ActiveSav = nullptr; // What the active session put into SavUtils::Sav, to tell a foreign SAV apart.
+		std::unordered_map<SavHandle, Session> Sessions;
+		std::unordered_map<std::string, SavHandle> Paths;
+		std::list<SavHandle> LRU; // Most recently used first.
+
+		SAV *Current(const SavHandle Handle) const;
+		bool Load(const SavHandle Handle, Session &S);
+		void Unload(const SavHandle Handle, Session &S);
+		void Drop(const SavHandle Handle);
+		void Touch(Session &S);
+		void Evict(const SavHandle Keep);
+	};
+};
+
+#endif
\ No newline at end of file
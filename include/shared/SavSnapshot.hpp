@@ -0,0 +1,89 @@
+/*
+*   This file is part of Sim2Editor-CPPCore
+*   Copyright (C) 2020-2021 Sim2Team
+*
+*   This program is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Additional Terms 7.b and 7.c of GPLv3 apply to this file:
+*       * Requiring preservation of specified reasonable legal notices or
+*         author attributions in that material or in the Appropriate Legal
+*         Notices displayed by works containing it.
+*       * Prohibiting misrepresentation of the origin of that material,
+*         or requiring that modified versions of such material be marked in
+*         reasonable ways as different from the original version.
+*/
+
+#ifndef _SIM2EDITOR_CPP_CORE_SAV_SNAPSHOT_HPP
+#define _SIM2EDITOR_CPP_CORE_SAV_SNAPSHOT_HPP
+
+#include "CoreCommon.hpp"
+
+
+namespace S2Core {
+	class SAV; // Forward declaration, as Sav.hpp includes this.
+
+	/*
+		An immutable copy of the SavBuffer.
+
+		Epochs are published by the writer through SAV::Publish() and are never touched again afterwards,
+		so any amount of readers can walk them at the same time.
+	*/
+	struct SavEpoch {
+		SavEpoch(const uint8_t *Data, const uint32_t Size, const uint64_t Generation);
+
+		std::unique_ptr<uint8_t[]> Data = nullptr;
+		uint32_t Size = 0;
+		uint64_t Generation = 0;
+	};
+
+
+	/*
+		Pins the latest published Epoch of a SAV to the calling thread.
+
+		As long as a SavSnapshot is alive, all SavUtils::Read* calls of that thread (and with that all GBASlot, NDSSlot etc. getters)
+		on that SAV read from the pinned Epoch instead of the live SavBuffer. That way readers never see a half done edit and never take a lock.
+
+		NOTE: Writes still go to the live SavBuffer, so only pin on reader threads.
+	*/
+	class SavSnapshot {
+	public:
+		SavSnapshot(const SAV &Sav);
+		~SavSnapshot();
+		SavSnapshot(const SavSnapshot &) = delete;
+		SavSnapshot &operator=(const SavSnapshot &) = delete;
+
+		bool Valid() const { return this->Epoch != nullptr; };
+		uint64_t Generation() const { return (this->Epoch ? this->Epoch->Generation : 0); };
+		const uint8_t *GetData() const { return (this->Epoch ? this->Epoch->Data.get() : nullptr); };
+		uint32_t GetSize() const { return (this->Epoch ? this->Epoch->Size : 0); };
+
+		/* The pinned Buffer and its owner of the calling thread, or nullptr if nothing is pinned. */
+		static const uint8_t *Pinned() { return SavSnapshot::PinnedData; };
+		static uint32_t PinnedSize() { return SavSnapshot::PinnedBytes; };
+		static const SAV *PinnedOwner() { return SavSnapshot::PinnedSav; };
+	private:
+		std::shared_ptr<const SavEpoch> Epoch = nullptr;
+
+		/* The previous pin, so that Snapshots can be nested. */
+		const uint8_t *PrevData = nullptr;
+		const SAV *PrevSav = nullptr;
+		uint32_t PrevBytes = 0;
+
+		static inline thread_local const uint8_t *PinnedData = nullptr;
+		static inline thread_local const SAV *PinnedSav = nullptr;
+		static inline thread_local uint32_t PinnedBytes = 0;
+	};
+};
+
+#endif
\ No newline at end of file
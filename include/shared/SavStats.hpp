@@ -0,0 +1,140 @@
+/*
+*   This file is part of Sim2Editor-CPPCore
+*   Copyright (C) 2020-2021 Sim2Team
+*
+*   This program is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Additional Terms 7.b and 7.c of GPLv3 apply to this file:
+*       * Requiring preservation of specified reasonable legal notices or
+*         author attributions in that material or in the Appropriate Legal
+*         Notices displayed by works containing it.
+*       * Prohibiting misrepresentation of the origin of that material,
+*         or requiring that modified versions of such material be marked in
+*         reasonable ways as different from the original version.
+*/
+
+#ifndef _SIM2EDITOR_CPP_CORE_SAV_STATS_HPP
+#define _SIM2EDITOR_CPP_CORE_SAV_STATS_HPP
+
+#include "CoreCommon.hpp"
+#include <atomic>
+#include <chrono>
+
+
+/*
+	The counters only exist, if the Core is built with S2CORE_STATS defined (for example -DS2CORE_STATS), for the whole Core.
+	Without it, the S2CORE_STAT macros expand to nothing, so not even their arguments get evaluated and SavStats::Stats() returns zeros.
+*/
+#ifdef S2CORE_STATS
+	#define S2CORE_STAT(Counter, Value) S2Core::SavStats::Add(S2Core::SavStat::Counter, (Value))
+	#define S2CORE_STAT_TIMER(Counter) const S2Core::SavStats::Timer SavStatTimer_(S2Core::SavStat::Counter)
+#else
+	#define S2CORE_STAT(Counter, Value) ((void)0)
+	#define S2CORE_STAT_TIMER(Counter) ((void)0)
+#endif
+
+
+namespace S2Core {
+	enum class SavStat : uint8_t {
+		Reads, ReadBytes, // SavUtils::Read and ReadArray.
+		Writes, WriteBytes, // SavUtils::Write and WriteArray, which actually wrote.
+		ViewReads, ViewReadBytes, // SavView and SavEditView Read, including the bit accessors.
+		ViewWrites, ViewWriteBytes, // SavEditView Write, including the bit accessors.
+		ChecksumRegions, ChecksumBytes, // Checksum::Calc.
+		ViewAllocs, // The std::unique_ptr returns, like SAV::_GBASlot() or GBASlot::House().
+		ItemShiftBytes, // GBAHouseItem::AddItem and RemoveItem moving the following data.
+		FileReadBytes, FileWriteBytes, // Loading SAVs and SavWriter.
+		Finishes, FinishNanos, // SavUtils::Finish and SavSessions::Flush, including the write.
+		Count
+	};
+
+	/* A snapshot of all counters. */
+	struct SavStatsData {
+		uint64_t Reads = 0, ReadBytes = 0;
+		uint64_t Writes = 0, WriteBytes = 0;
+		uint64_t ViewReads = 0, ViewReadBytes = 0;
+		uint64_t ViewWrites = 0, ViewWriteBytes = 0;
+		uint64_t ChecksumRegions = 0, ChecksumBytes = 0;
+		uint64_t ViewAllocs = 0;
+		uint64_t ItemShiftBytes = 0;
+		uint64_t FileReadBytes = 0, FileWriteBytes = 0;
+		uint64_t Finishes = 0, FinishNanos = 0;
+	};
+
+	/*
+		Process wide counters of what the Core does, to see where the time goes.
+
+		The counters are relaxed atomics, so they can be used from any thread, but a snapshot taken while other threads work is not a single point in time.
+		Resetting them resets them for everyone, so to attribute the cost to a session or a task, bind a Sink to the thread doing the work.
+		Everything counted on a thread goes to the process wide counters and to the Sink bound to it, if any (SavSessions binds one per session).
+	*/
+	namespace SavStats {
+		/*
+			A set of counters of its own, which only gets what is counted on a thread while bound to it.
+			The counters are plain integers, so only read a Sink on the thread it is bound to, or after unbinding it.
+		*/
+		struct Sink {
+			uint64_t Counters[(size_t)SavStat::Count] = { };
+
+			SavStatsData Stats(const bool Clear = false);
+		};
+
+		SavStatsData Stats(const bool Clear = false);
+		void Reset();
+
+		Sink *Bound();
+		Sink *Bind(Sink *Target);
+
+		/* Binds a Sink for as long as it lives, and then the previous one again. */
+		class Scope {
+		public:
+			Scope(Sink *Target) : Prev(Bind(Target)) { };
+			~Scope() { Bind(this->Prev); };
+
+			Scope(const Scope &) = delete;
+			Scope &operator=(const Scope &) = delete;
+		private:
+			Sink *Prev = nullptr;
+		};
+
+		#ifdef S2CORE_STATS
+			static constexpr bool Enabled = true;
+			extern std::atomic<uint64_t> Counters[(size_t)SavStat::Count];
+			extern thread_local Sink *BoundSink;
+
+			inline void Add(const SavStat Counter, const uint64_t Value) {
+				Counters[(size_t)Counter].fetch_add(Value, std::memory_order_relaxed);
+				if (BoundSink) BoundSink->Counters[(size_t)Counter] += Value;
+			};
+
+			/* Adds the nanoseconds it lived to a counter. */
+			class Timer {
+			public:
+				Timer(const SavStat Counter) : Counter(Counter), Start(std::chrono::steady_clock::now()) { };
+				~Timer() { Add(this->Counter, std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - this->Start).count()); };
+
+				Timer(const Timer &) = delete;
+				Timer &operator=(const Timer &) = delete;
+			private:
+				SavStat Counter;
+				std::chrono::steady_clock::time_point Start;
+			};
+
+		#else
+			static constexpr bool Enabled = false;
+		#endif
+	};
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,64 @@
+/*
+*   This file is part of Sim2Editor-CPPCore
+*   Copyright (C) 2020-2021 Sim2Team
+*
+*   This program is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Additional Terms 7.b and 7.c of GPLv3 apply to this file:
+*       * Requiring preservation of specified reasonable legal notices or
+*         author attributions in that material or in the Appropriate Legal
+*         Notices displayed by works containing it.
+*       * Prohibiting misrepresentation of the origin of that material,
+*         or requiring that modified versions of such material be marked in
+*         reasonable ways as different from the original version.
+*/
+
+#ifndef _SIM2EDITOR_CPP_CORE_SAV_TRANSFER_HPP
+#define _SIM2EDITOR_CPP_CORE_SAV_TRANSFER_HPP
+
+#include "CoreCommon.hpp"
+#include <vector>
+
+
+namespace S2Core {
+	class SAV; // Forward declaration.
+
+	/*
+		Moves whole Slots between SAVs, or inside of one.
+
+		GBA Slots (1 - 4) are copied block wise.
+		NDS Slots (0 - 2) are written to the oldest unused physical Slot of the target, with the next save counter and the target Slot number,
+		so the game picks the copy up as the latest save of that Slot and the previous one stays around as the older save, like the game does it.
+
+		Single Slot format, for keeping characters around on their own:
+			'S2SL', Version (u8), SavType (u8), NDSSavRegion (u8), Flags (u8, 0x1 = RLE), Image hash (u64), Payload size (u32),
+			then the 0x1000 byte Slot image, RLE compressed if that is smaller (which it nearly always is).
+	*/
+	namespace SavTransfer {
+		bool CopySlot(const SAV &Src, const uint8_t SrcSlot, SAV &Dst, const uint8_t DstSlot);
+		int8_t NDSTargetSlot(const SAV &Sav);
+
+		std::vector<uint8_t> ExportSlot(const SAV &Sav, const uint8_t Slot);
+		bool ImportSlot(SAV &Sav, const uint8_t Slot, const uint8_t *Data, const size_t Size);
+
+		static constexpr uint32_t SlotSize = 0x1000;
+		static constexpr uint8_t NDSPhysicalSlots = 5;
+
+		static constexpr uint8_t Magic[4] = { 'S', '2', 'S', 'L' };
+		static constexpr uint8_t Version = 1;
+		static constexpr uint32_t HeaderSize = 0x14;
+	};
+};
+
+#endif
\ No newline at end of file
@@ -29,6 +29,8 @@
 
 #include "DataHelper.hpp"
 #include "Sav.hpp"
+#include "SavStats.hpp"
+#include "SavWriter.hpp"
 
 
 namespace S2Core {
@@ -42,18 +44,28 @@ namespace S2Core {
 
 		SavType LoadSav(const std::string &File, const std::string &BasePath = "", const bool DoBackup = false);
 		SavType LoadSav(std::unique_ptr<uint8_t[]> &Data, const uint32_t Size, const std::string &BasePath = "", const bool DoBackup = false);
-		bool CreateBackup(const std::string &BasePath);
-		void Finish(const bool Reset = true);
+		SavType LoadSav(uint8_t *Data, const uint32_t Size);
+		SavType LoadSav(const uint8_t *Data, const uint32_t Size);
+		SavType LoadSav(const SavReader &Reader, const uint32_t SizeHint = 0, const std::string &BasePath = "", const bool DoBackup = false);
+		bool CreateBackup(const std::string &BasePath, const bool Async = false);
+		bool FlushBackups();
+		uint32_t Finish(const bool Reset = true, const SavWriteMode Mode = SavWriteMode::InPlace);
 		bool ChangesMade();
 
+		/* The pinned Epoch of the calling thread, if it is one of the loaded SAV. Pins of other SAVs are ignored. */
+		inline const uint8_t *Pinned() { return (SavSnapshot::PinnedOwner() == SavUtils::Sav.get() ? SavSnapshot::Pinned() : nullptr); };
 
 		/*
-			Read from the SavBuffer.
+			Read from the SavBuffer, or from the pinned Epoch if the calling thread holds a SavSnapshot of it.
 
 			const uint32_t Offs: The Offset from where to read.
 		*/
 		template <typename T>
 		T Read(const uint32_t Offs) {
+			S2CORE_STAT(Reads, 1);
+			S2CORE_STAT(ReadBytes, sizeof(T));
+
+			if (SavUtils::Pinned()) return DataHelper::Read<T>(SavUtils::Pinned(), Offs);
 			if (!SavUtils::Sav || !SavUtils::Sav->GetValid() || !SavUtils::Sav->GetData()) return 0;
 			return DataHelper::Read<T>(SavUtils::Sav->GetData(), Offs);
 		};
@@ -66,10 +78,56 @@ namespace S2Core {
 		*/
 		template <typename T>
 		void Write(const uint32_t Offs, T Data) {
-			if (!SavUtils::Sav || !SavUtils::Sav->GetValid()) return;
+			if (!SavUtils::Sav || !SavUtils::Sav->GetValid() || SavUtils::Sav->GetReadOnly()) return;
 
 			if (DataHelper::Write<T>(SavUtils::Sav->GetData(), Offs, Data)) {
+				S2CORE_STAT(Writes, 1);
+				S2CORE_STAT(WriteBytes, sizeof(T));
+
+				if (!SavUtils::Sav->GetChangesMade()) SavUtils::Sav->SetChangesMade(true);
+				SavUtils::Sav->MarkDirty(Offs, sizeof(T));
+			}
+		};
+
+		/*
+			Read an array from the SavBuffer, or from the pinned Epoch if the calling thread holds a SavSnapshot of it.
+
+			const uint32_t Offs: The Offset of the first element.
+			T *Out: Where to store the elements.
+			const uint32_t Count: The amount of elements.
+			const uint32_t Stride: The distance between two elements, for elements inside of bigger records.
+
+			Returns false and leaves Out untouched, if nothing could be read.
+		*/
+		template <typename T>
+		bool ReadArray(const uint32_t Offs, T *Out, const uint32_t Count, const uint32_t Stride = sizeof(T)) {
+			S2CORE_STAT(Reads, 1);
+			S2CORE_STAT(ReadBytes, Count * sizeof(T));
+
+			if (SavUtils::Pinned()) return DataHelper::ReadArray<T>(SavUtils::Pinned(), Offs, Out, Count, Stride);
+			if (!SavUtils::Sav || !SavUtils::Sav->GetValid() || !SavUtils::Sav->GetData()) return false;
+			return DataHelper::ReadArray<T>(SavUtils::Sav->GetData(), Offs, Out, Count, Stride);
+		};
+
+		/*
+			Write an array to the SavBuffer.
+			The SAV is checked and the covered range marked dirty only once for the whole array.
+
+			const uint32_t Offs: The Offset of the first element.
+			const T *In: The elements to write.
+			const uint32_t Count: The amount of elements.
+			const uint32_t Stride: The distance between two elements, for elements inside of bigger records.
+		*/
+		template <typename T>
+		void WriteArray(const uint32_t Offs, const T *In, const uint32_t Count, const uint32_t Stride = sizeof(T)) {
+			if (!SavUtils::Sav || !SavUtils::Sav->GetValid() || SavUtils::Sav->GetReadOnly() || !Count) return;
+
+			if (DataHelper::WriteArray<T>(SavUtils::Sav->GetData(), Offs, In, Count, Stride)) {
+				S2CORE_STAT(Writes, 1);
+				S2CORE_STAT(WriteBytes, Count * sizeof(T));
+
 				if (!SavUtils::Sav->GetChangesMade()) SavUtils::Sav->SetChangesMade(true);
+				SavUtils::Sav->MarkDirty(Offs, DataHelper::ArraySpan<T>(Count, Stride));
 			}
 		};
 
@@ -0,0 +1,69 @@
+/*
+*   This file is part of Sim2Editor-CPPCore
+*   Copyright (C) 2020-2021 Sim2Team
+*
+*   This program is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Additional Terms 7.b and 7.c of GPLv3 apply to this file:
+*       * Requiring preservation of specified reasonable legal notices or
+*         author attributions in that material or in the Appropriate Legal
+*         Notices displayed by works containing it.
+*       * Prohibiting misrepresentation of the origin of that material,
+*         or requiring that modified versions of such material be marked in
+*         reasonable ways as different from the original version.
+*/
+
+#ifndef _SIM2EDITOR_CPP_CORE_SAV_VALIDATOR_HPP
+#define _SIM2EDITOR_CPP_CORE_SAV_VALIDATOR_HPP
+
+#include "SavLayout.hpp"
+
+
+namespace S2Core {
+	enum class SavIssueKind : uint8_t {
+		Range, // A Field is outside of its legal range, like an unofficial Episode or a Painting Flag >= 0x29.
+		Count, // A stored Item count does not match the amount of Items, or the House Item count is above 12.
+		Checksum // A Checksum does not match.
+	};
+
+	struct SavIssue {
+		SavIssueKind Kind;
+		std::string Path; // Like 'Slot1.CurrentEpisode' or 'Painting3.HeaderChecksum'.
+		uint32_t Offs; // The absolute offset inside the SavBuffer.
+		uint32_t Value; // The stored value.
+		uint32_t Expected; // The clamped value, the actual count or the calculated Checksum.
+		bool Repaired = false;
+	};
+
+	struct SavReport {
+		std::vector<SavIssue> Issues;
+		uint32_t Fields = 0, Checksums = 0; // How many got checked.
+		uint32_t Repaired = 0;
+
+		bool Clean() const { return this->Issues.empty(); };
+	};
+
+	/*
+		Checks every known Field against its legal range and every Checksum in one pass over the SavBuffer.
+
+		Repair() additionally clamps illegal values the same way as the setters do, fixes the Item counts and fixes the Checksums.
+		House Item counts above 12 are only reported, as fixing them moves all data behind the House Items.
+	*/
+	namespace SavValidator {
+		SavReport Check(const SAV &Sav);
+		SavReport Repair(SAV &Sav);
+	};
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,144 @@
+/*
+*   This file is part of Sim2Editor-CPPCore
+*   Copyright (C) 2020-2021 Sim2Team
+*
+*   This program is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Additional Terms 7.b and 7.c of GPLv3 apply to this file:
+*       * Requiring preservation of specified reasonable legal notices or
+*         author attributions in that material or in the Appropriate Legal
+*         Notices displayed by works containing it.
+*       * Prohibiting misrepresentation of the origin of that material,
+*         or requiring that modified versions of such material be marked in
+*         reasonable ways as different from the original version.
+*/
+
+#ifndef _SIM2EDITOR_CPP_CORE_SAV_VIEW_HPP
+#define _SIM2EDITOR_CPP_CORE_SAV_VIEW_HPP
+
+#include "CoreCommon.hpp"
+#include "SavStats.hpp"
+#include <cassert> // assert.
+
+
+namespace S2Core {
+	class SAV; // Forward declaration.
+
+	/*
+		A read only window over a range of a SAV.
+
+		Everything that SavUtils::Read* checks on each call (Sav set, valid, Buffer present, in bounds) is checked once in the constructor.
+		If the view is valid, the accessors are plain loads (plus the SavStats counters, if built with them). Offsets passed to them are relative to the start of the view
+		and only checked with assert, so release builds don't check them at all.
+
+		Like SavUtils::Read, the view reads from the pinned Epoch if the calling thread holds a SavSnapshot of the same SAV.
+		NOTE: Don't keep views around across a LoadSav, Resize or anything else that replaces the SavBuffer.
+	*/
+	class SavView {
+	public:
+		SavView(const uint32_t Offs, const uint32_t Size); // Over SavUtils::Sav.
+		SavView(const SAV &Sav, const uint32_t Offs, const uint32_t Size);
+
+		bool Valid() const { return this->Data != nullptr; };
+		uint32_t GetOffs() const { return this->Offs; };
+		uint32_t GetSize() const { return this->Size; };
+		const uint8_t *GetData() const { return this->Data; };
+
+		template <typename T>
+		T Read(const uint32_t Pos) const {
+			assert(this->Data && Pos + sizeof(T) <= this->Size);
+			S2CORE_STAT(ViewReads, 1);
+			S2CORE_STAT(ViewReadBytes, sizeof(T));
+
+			T Res;
+			memcpy(&Res, this->Data + Pos, sizeof(T));
+			return Res;
+		};
+
+		bool ReadBit(const uint32_t Pos, const uint8_t BitIndex) const { return (this->Read<uint8_t>(Pos) >> BitIndex) & 0x1; };
+		uint8_t ReadBits(const uint32_t Pos, const bool First = true) const { return (First ? (this->Read<uint8_t>(Pos) & 0xF) : (this->Read<uint8_t>(Pos) >> 4)); };
+	private:
+		const uint8_t *Data = nullptr;
+		uint32_t Offs = 0, Size = 0;
+
+		void Init(const SAV *Sav, const uint32_t Offs, const uint32_t Size);
+	};
+
+	/*
+		A writable window over a range of a SAV.
+
+		Checked once in the constructor like SavView, and additionally the SAV must not be read-only.
+		Writes are plain stores; ChangesMade and the dirty range of the view are only updated once when the view goes out of scope
+		(or on Commit()), so don't publish or write the SAV while a view with pending writes is still alive.
+	*/
+	class SavEditView {
+	public:
+		SavEditView(const uint32_t Offs, const uint32_t Size); // Over SavUtils::Sav.
+		SavEditView(SAV &Sav, const uint32_t Offs, const uint32_t Size);
+		~SavEditView() { this->Commit(); };
+		SavEditView(const SavEditView &) = delete;
+		SavEditView &operator=(const SavEditView &) = delete;
+
+		bool Valid() const { return this->Data != nullptr; };
+		uint32_t GetOffs() const { return this->Offs; };
+		uint32_t GetSize() const { return this->Size; };
+		uint8_t *GetData() { this->Touched = true; return this->Data; };
+
+		template <typename T>
+		T Read(const uint32_t Pos) const {
+			assert(this->Data && Pos + sizeof(T) <= this->Size);
+			S2CORE_STAT(ViewReads, 1);
+			S2CORE_STAT(ViewReadBytes, sizeof(T));
+
+			T Res;
+			memcpy(&Res, this->Data + Pos, sizeof(T));
+			return Res;
+		};
+
+		template <typename T>
+		void Write(const uint32_t Pos, const T Data) {
+			assert(this->Data && Pos + sizeof(T) <= this->Size);
+			S2CORE_STAT(ViewWrites, 1);
+			S2CORE_STAT(ViewWriteBytes, sizeof(T));
+
+			memcpy(this->Data + Pos, &Data, sizeof(T));
+			this->Touched = true;
+		};
+
+		bool ReadBit(const uint32_t Pos, const uint8_t BitIndex) const { return (this->Read<uint8_t>(Pos) >> BitIndex) & 0x1; };
+		void WriteBit(const uint32_t Pos, const uint8_t BitIndex, const bool IsSet) {
+			const uint8_t Byte = this->Read<uint8_t>(Pos);
+			this->Write<uint8_t>(Pos, (IsSet ? (Byte | (1 << BitIndex)) : (Byte & ~(1 << BitIndex))));
+		};
+
+		uint8_t ReadBits(const uint32_t Pos, const bool First = true) const { return (First ? (this->Read<uint8_t>(Pos) & 0xF) : (this->Read<uint8_t>(Pos) >> 4)); };
+		void WriteBits(const uint32_t Pos, const bool First, const uint8_t Data) {
+			assert(Data <= 0xF);
+
+			const uint8_t Byte = this->Read<uint8_t>(Pos);
+			this->Write<uint8_t>(Pos, (First ? ((Byte & 0xF0) | Data) : ((Byte & 0x0F) | (Data << 4))));
+		};
+
+		void Commit();
+	private:
+		SAV *Sav = nullptr;
+		uint8_t *Data = nullptr;
+		uint32_t Offs = 0, Size = 0;
+		bool Touched = false;
+
+		void Init(SAV *Sav, const uint32_t Offs, const uint32_t Size);
+	};
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,76 @@
+/*
+*   This file is part of Sim2Editor-CPPCore
+*   Copyright (C) 2020-2021 Sim2Team
+*
+*   This program is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Additional Terms 7.b and 7.c of GPLv3 apply to this file:
+*       * Requiring preservation of specified reasonable legal notices or
+*         author attributions in that material or in the Appropriate Legal
+*         Notices displayed by works containing it.
+*       * Prohibiting misrepresentation of the origin of that material,
+*         or requiring that modified versions of such material be marked in
+*         reasonable ways as different from the original version.
+*/
+
+#ifndef _SIM2EDITOR_CPP_CORE_SAV_WATCHER_HPP
+#define _SIM2EDITOR_CPP_CORE_SAV_WATCHER_HPP
+
+#include "SavLayout.hpp"
+
+
+namespace S2Core {
+	/* What changed on an external write. Ranges are relative to the Sav data, like SavSectionRef offsets. */
+	struct SavChangeEvent {
+		std::vector<SavSectionRef> Sections; // Slots / Paintings, which got reloaded.
+		std::vector<std::pair<uint32_t, uint32_t>> Ranges; // Offset and size of the reloaded blocks.
+		std::vector<std::pair<uint32_t, uint32_t>> Conflicts; // Blocks, which changed on disk but also have unsaved local changes. Those are kept.
+		bool Resized = false; // The file size changed, so it needs a full LoadSav().
+
+		bool Empty() const { return this->Ranges.empty() && this->Conflicts.empty() && !this->Resized; };
+	};
+
+	/*
+		Watches the SavFile of a SAV for external writes (through inotify, so Linux only) and reloads only the changed blocks.
+
+		The directory of the SavFile is watched, so tools, which write a temporary file and rename it over the SavFile, are noticed as well.
+		Only finished writes count (the writer closed the SavFile or renamed over it), so a half written SavFile doesn't get reloaded.
+		Our own writes show up as events too, but as the blocks match the SavBuffer, they result in an empty SavChangeEvent.
+
+		Call Check() when GetFD() becomes readable, or use Wait().
+	*/
+	class SavWatcher {
+	public:
+		SavWatcher(SAV &Sav);
+		~SavWatcher();
+		SavWatcher(const SavWatcher &) = delete;
+		SavWatcher &operator=(const SavWatcher &) = delete;
+
+		bool Start();
+		void Stop();
+		int GetFD() const { return this->FD; };
+
+		bool Wait(const int Timeout);
+		SavChangeEvent Check();
+		SavChangeEvent Reload();
+
+		static constexpr uint32_t BlockSize = 0x1000;
+	private:
+		SAV &Sav;
+		int FD = -1, Watch = -1;
+		std::string Dir = "", Name = "";
+	};
+};
+
+#endif
\ No newline at end of file
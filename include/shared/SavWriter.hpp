@@ -0,0 +1,62 @@
+/*
+*   This file is part of Sim2Editor-CPPCore
+*   Copyright (C) 2020-2021 Sim2Team
+*
+*   This program is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Additional Terms 7.b and 7.c of GPLv3 apply to this file:
+*       * Requiring preservation of specified reasonable legal notices or
+*         author attributions in that material or in the Appropriate Legal
+*         Notices displayed by works containing it.
+*       * Prohibiting misrepresentation of the origin of that material,
+*         or requiring that modified versions of such material be marked in
+*         reasonable ways as different from the original version.
+*/
+
+#ifndef _SIM2EDITOR_CPP_CORE_SAV_WRITER_HPP
+#define _SIM2EDITOR_CPP_CORE_SAV_WRITER_HPP
+
+#include "CoreCommon.hpp"
+
+
+namespace S2Core {
+	class SAV; // Forward declaration.
+
+	enum class SavWriteMode : uint8_t {
+		InPlace, // Rewrite the whole SavFile in place, like it always has been done.
+		Atomic, // Write a temporary file, sync it and rename it over the SavFile, so a crash leaves either the old or the new SavFile.
+		Minimal, // Only write the 0x1000 byte blocks with dirty bytes and sync them.
+		Rotate // NDS: Like the game, edited Slots are saved to the next physical Slot with a newer save counter, then written like Minimal.
+	};
+
+	/*
+		Writes a SAV back to its SavFile.
+
+		Before writing, the Checksums of all dirty Sections get fixed.
+		NOTE: Minimal only knows about writes done through SavUtils, SavPatch and such, which mark the SAV dirty.
+		If the SAV is changed without any dirty bytes (raw GetData() writes), Minimal writes the whole SavFile.
+
+		Rotate leaves the previous save of each edited NDS Slot untouched on disk, so the game still has it as the fallback.
+		The edited physical Slot is restored from the SavFile in memory as well, so the SAV keeps matching the SavFile.
+		NOTE: The Slots move to other physical Slots, so fetch NDSSlot objects again after a Rotate write.
+		Old ones still point to the previous save, and edits through them would land in the fallback.
+		On GBA it is the same as Minimal.
+	*/
+	namespace SavWriter {
+		bool Write(SAV &Sav, const SavWriteMode Mode, uint32_t &Written);
+		static constexpr uint32_t BlockSize = 0x1000;
+	};
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,53 @@
+/*
+*   This file is part of Sim2Editor-CPPCore
+*   Copyright (C) 2020-2021 Sim2Team
+*
+*   This program is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Additional Terms 7.b and 7.c of GPLv3 apply to this file:
+*       * Requiring preservation of specified reasonable legal notices or
+*         author attributions in that material or in the Appropriate Legal
+*         Notices displayed by works containing it.
+*       * Prohibiting misrepresentation of the origin of that material,
+*         or requiring that modified versions of such material be marked in
+*         reasonable ways as different from the original version.
+*/
+
+#ifndef _SIM2EDITOR_CPP_CORE_STRING_CODEC_HPP
+#define _SIM2EDITOR_CPP_CORE_STRING_CODEC_HPP
+
+#include "CoreCommon.hpp"
+
+
+/*
+	Transcodes the Sav character sets from and to UTF-8.
+
+	The GBA and the international NDS versions store names as single bytes of Latin-1 (0x80 and above are umlauts, accents and such).
+	The japanese NDS version stores ASCII and half-width katakana as JIS X 0201 bytes, 0xA1 - 0xDF being U+FF61 - U+FF9F.
+	The japanese bytes without a character (0x80 - 0xA0 and 0xE0 - 0xFF) decode to U+F780 - U+F7FF and encode back to the same byte.
+	Both directions go through 256 entry tables, which are built at compile time.
+
+	NDSSavRegion::Unknown (so GBA as well) is treated like NDSSavRegion::Int.
+*/
+namespace S2Core {
+	namespace StringCodec {
+		/* The maximum amount of UTF-8 bytes a Sav string of Length bytes can decode to. */
+		constexpr size_t MaxUTF8(const uint32_t Length) { return Length * 3; };
+
+		size_t Decode(const uint8_t *Src, const uint32_t Length, char *Out, const size_t OutSize, const NDSSavRegion Region = NDSSavRegion::Int);
+		uint32_t Encode(const char *Str, const size_t StrLength, uint8_t *Out, const uint32_t Length, const NDSSavRegion Region = NDSSavRegion::Int);
+	};
+};
+
+#endif
\ No newline at end of file
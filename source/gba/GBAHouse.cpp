@@ -37,5 +37,5 @@ namespace S2Core {
 	void GBAHouse::Roomdesign(const uint8_t V) { SavUtils::WriteBits(this->Offs + 0x2E, true, V); };
 
 	/* Get the Items of your House / Room. */
-	std::unique_ptr<GBAHouseItem> GBAHouse::Items() const { return std::make_unique<GBAHouseItem>(this->Offs + 0xD6); };
+	std::unique_ptr<GBAHouseItem> GBAHouse::Items() const { S2CORE_STAT(ViewAllocs, 1); return std::make_unique<GBAHouseItem>(this->Offs + 0xD6); };
 };
\ No newline at end of file
@@ -0,0 +1,326 @@
+/*
+*   This file is part of Sim2Editor-CPPCore
+*   Copyright (C) 2020-2021 Sim2Team
+*
+*   This program is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Additional Terms 7.b and 7.c of GPLv3 apply to this file:
+*       * Requiring preservation of specified reasonable legal notices or
+*         author attributions in that material or in the Appropriate Legal
+*         Notices displayed by works containing it.
+*       * Prohibiting misrepresentation of the origin of that material,
+*         or requiring that modified versions of such material be marked in
+*         reasonable ways as different from the original version.
+*/
+
+#include "GBAHouseGrid.hpp"
+#include "../shared/DataHelper.hpp"
+
+
+namespace S2Core {
+	GBAItemFootprint GBAHouseGrid::Footprints[0x100];
+
+	/* Turn the raw Direction byte into the enum, like GBAHouseItem::Direction() does. */
+	static GBAHouseItemDirection ToDirection(const uint8_t D) {
+		switch(D) {
+			case 0x1:
+				return GBAHouseItemDirection::Right;
+
+			case 0x3:
+				return GBAHouseItemDirection::Down;
+
+			case 0x5:
+				return GBAHouseItemDirection::Left;
+
+			case 0x7:
+				return GBAHouseItemDirection::Up;
+		}
+
+		return GBAHouseItemDirection::Invalid;
+	};
+
+
+	/*
+		Create an empty grid.
+
+		const uint8_t Width: The width of the room in tiles, at most MaxSize.
+		const uint8_t Height: The height of the room in tiles, at most MaxSize.
+	*/
+	GBAHouseGrid::GBAHouseGrid(const uint8_t Width, const uint8_t Height)
+		: Width(std::max<uint8_t>(1, std::min<uint8_t>(GBAHouseGrid::MaxSize, Width))), Height(std::max<uint8_t>(1, std::min<uint8_t>(GBAHouseGrid::MaxSize, Height))) { };
+
+
+	/* Remove all Items from the grid. */
+	void GBAHouseGrid::Clear() {
+		memset(this->Rows, 0x0, sizeof(this->Rows));
+		memset(this->Cells, 0x0, sizeof(this->Cells));
+		this->Count = 0;
+	};
+
+
+	/*
+		Build the grid from the House Items of the SavBuffer.
+
+		const GBAHouseItem &Items: The House Items.
+	*/
+	void GBAHouseGrid::Build(const GBAHouseItem &Items) {
+		this->Clear();
+
+		uint8_t IDs[GBAHouseGrid::MaxItems];
+		const uint8_t CT = Items.IDs(IDs);
+
+		for (uint8_t Idx = 0; Idx < CT; Idx++) this->Place(Idx, IDs[Idx], Items.XPos(Idx), Items.YPos(Idx), Items.Direction(Idx));
+	};
+
+	/*
+		Build the grid from the House Items of any Buffer.
+
+		const uint8_t *Data: The SavBuffer.
+		const uint32_t ItemOffs: The Offset of the House Item count, so Slot Offset + 0xD6 on GBA.
+	*/
+	void GBAHouseGrid::Build(const uint8_t *Data, const uint32_t ItemOffs) {
+		this->Clear();
+		if (!Data) return;
+
+		const uint8_t CT = std::min<uint8_t>(GBAHouseGrid::MaxItems, Data[ItemOffs]);
+		uint8_t IDs[GBAHouseGrid::MaxItems], XPos[GBAHouseGrid::MaxItems], YPos[GBAHouseGrid::MaxItems], Dirs[GBAHouseGrid::MaxItems];
+
+		DataHelper::ReadArray<uint8_t>(Data, ItemOffs + 0x1, IDs, CT, 0x6);
+		DataHelper::ReadArray<uint8_t>(Data, ItemOffs + 0x4, XPos, CT, 0x6);
+		DataHelper::ReadArray<uint8_t>(Data, ItemOffs + 0x5, YPos, CT, 0x6);
+		DataHelper::ReadArray<uint8_t>(Data, ItemOffs + 0x6, Dirs, CT, 0x6);
+
+		for (uint8_t Idx = 0; Idx < CT; Idx++) this->Place(Idx, IDs[Idx], XPos[Idx], YPos[Idx], ToDirection(Dirs[Idx]));
+	};
+
+
+	/* Returns the bits X - (X + W - 1) of a row. */
+	uint32_t GBAHouseGrid::RowMask(const uint8_t X, const uint8_t W) const {
+		if (X >= GBAHouseGrid::MaxSize || !W) return 0x0;
+
+		const uint32_t Bits = (W >= 32 ? 0xFFFFFFFF : ((1U << W) - 1));
+		return Bits << X;
+	};
+
+	/* Add or remove the tiles of an Item. Parts outside of the room are ignored. */
+	void GBAHouseGrid::Mark(const Entry &Item, const bool Add) {
+		const GBAItemFootprint Size = GBAHouseGrid::Footprint(Item.ID, Item.Direction);
+
+		for (uint8_t Y = Item.Y; Y < std::min<uint16_t>(this->Height, Item.Y + Size.Height); Y++) {
+			for (uint8_t X = Item.X; X < std::min<uint16_t>(this->Width, Item.X + Size.Width); X++) {
+				if (Add) this->Cells[Y][X]++;
+				else if (this->Cells[Y][X]) this->Cells[Y][X]--;
+
+				if (this->Cells[Y][X]) this->Rows[Y] |= (1U << X);
+				else this->Rows[Y] &= ~(1U << X);
+			}
+		}
+	};
+
+
+	/* Returns how many placed Items have no footprint set. Collides() and FirstFree() refuse to answer, as long as it isn't 0. */
+	uint8_t GBAHouseGrid::GetUnknown() const {
+		uint8_t Unknown = 0;
+
+		for (uint8_t Idx = 0; Idx < this->Count; Idx++) {
+			if (!GBAHouseGrid::KnownFootprint(this->Items[Idx].ID)) Unknown++;
+		}
+
+		return Unknown;
+	};
+
+
+	/* Returns, if the footprint of an ID or of a placed Item (other than the one at Ignore) is only the 1x1 default. */
+	bool GBAHouseGrid::Guessed(const uint8_t ID, const int8_t Ignore) const {
+		if (!GBAHouseGrid::KnownFootprint(ID)) return true;
+
+		for (uint8_t Idx = 0; Idx < this->Count; Idx++) {
+			if (Idx != Ignore && !GBAHouseGrid::KnownFootprint(this->Items[Idx].ID)) return true;
+		}
+
+		return false;
+	};
+
+
+	/* Returns if a tile is free. Tiles outside of the room are never free. */
+	bool GBAHouseGrid::Free(const uint8_t X, const uint8_t Y) const {
+		if (X >= this->Width || Y >= this->Height) return false;
+
+		return !(this->Rows[Y] & (1U << X));
+	};
+
+	/* Returns the Index of the Item covering a tile, or -1 if the tile is free. */
+	int8_t GBAHouseGrid::ItemAt(const uint8_t X, const uint8_t Y) const {
+		if (this->Free(X, Y)) return -1;
+
+		for (int8_t Idx = this->Count - 1; Idx >= 0; Idx--) { // The last placed one is on top.
+			const GBAItemFootprint Size = GBAHouseGrid::Footprint(this->Items[Idx].ID, this->Items[Idx].Direction);
+
+			if (X >= this->Items[Idx].X && X < this->Items[Idx].X + Size.Width && Y >= this->Items[Idx].Y && Y < this->Items[Idx].Y + Size.Height) return Idx;
+		}
+
+		return -1;
+	};
+
+
+	/*
+		Check if an Item would collide with the room bounds or other Items.
+
+		const uint8_t ID: The Item ID, for the footprint.
+		const uint8_t X: The X Position.
+		const uint8_t Y: The Y Position.
+		const GBAHouseItemDirection Direction: The Direction.
+		const int8_t Ignore: An Item Index to ignore, for checking where an already placed Item could be moved to.
+
+		Returns true as well, if the footprint of the ID or of another placed Item is unknown (see KnownFootprint()), as the answer would be a guess.
+	*/
+	bool GBAHouseGrid::Collides(const uint8_t ID, const uint8_t X, const uint8_t Y, const GBAHouseItemDirection Direction, const int8_t Ignore) const {
+		if (this->Guessed(ID, Ignore)) return true;
+
+		const GBAItemFootprint Size = GBAHouseGrid::Footprint(ID, Direction);
+		if (X + Size.Width > this->Width || Y + Size.Height > this->Height) return true;
+
+		const uint32_t Mask = this->RowMask(X, Size.Width);
+
+		if (Ignore < 0 || Ignore >= this->Count) {
+			for (uint8_t Row = Y; Row < Y + Size.Height; Row++) {
+				if (this->Rows[Row] & Mask) return true;
+			}
+
+			return false;
+		}
+
+		/* The ignored Item may share tiles with others, so go by the tile counts there. */
+		const Entry &Own = this->Items[Ignore];
+		const GBAItemFootprint OwnSize = GBAHouseGrid::Footprint(Own.ID, Own.Direction);
+
+		for (uint8_t Row = Y; Row < Y + Size.Height; Row++) {
+			if (!(this->Rows[Row] & Mask)) continue;
+
+			for (uint8_t Col = X; Col < X + Size.Width; Col++) {
+				const bool OwnTile = (Col >= Own.X && Col < Own.X + OwnSize.Width && Row >= Own.Y && Row < Own.Y + OwnSize.Height);
+				if (this->Cells[Row][Col] > (OwnTile ? 1 : 0)) return true;
+			}
+		}
+
+		return false;
+	};
+
+	/*
+		Find the first free spot for an Item, going row by row from the top left.
+
+		const uint8_t ID: The Item ID, for the footprint.
+		const GBAHouseItemDirection Direction: The Direction.
+		uint8_t &X: Where to store the X Position.
+		uint8_t &Y: Where to store the Y Position.
+
+		Returns false if the Item fits nowhere, or if the footprint of the ID or of a placed Item is unknown (see KnownFootprint()).
+	*/
+	bool GBAHouseGrid::FirstFree(const uint8_t ID, const GBAHouseItemDirection Direction, uint8_t &X, uint8_t &Y) const {
+		if (this->Guessed(ID, -1)) return false;
+
+		const GBAItemFootprint Size = GBAHouseGrid::Footprint(ID, Direction);
+		if (Size.Width > this->Width || Size.Height > this->Height) return false;
+
+		const uint32_t Starts = this->RowMask(0, this->Width - Size.Width + 1); // Valid start columns.
+
+		for (uint8_t Row = 0; Row + Size.Height <= this->Height; Row++) {
+			uint32_t Used = 0x0;
+			for (uint8_t Idx = 0; Idx < Size.Height; Idx++) Used |= this->Rows[Row + Idx];
+
+			/* A start column is good, if it and the next Width - 1 columns are free. */
+			uint32_t Good = ~Used & Starts;
+			for (uint8_t Idx = 1; Idx < Size.Width && Good; Idx++) Good &= ~(Used >> Idx);
+			if (!Good) continue;
+
+			uint8_t Col = 0;
+			while (!(Good & (1U << Col))) Col++;
+
+			X = Col;
+			Y = Row;
+			return true;
+		}
+
+		return false;
+	};
+
+
+	/*
+		Place an Item, or replace the one at Index.
+
+		const uint8_t Index: The Item Index. An Index of GetCount() appends.
+		const uint8_t ID: The Item ID.
+		const uint8_t X: The X Position.
+		const uint8_t Y: The Y Position.
+		const GBAHouseItemDirection Direction: The Direction.
+	*/
+	void GBAHouseGrid::Place(const uint8_t Index, const uint8_t ID, const uint8_t X, const uint8_t Y, const GBAHouseItemDirection Direction) {
+		if (Index > this->Count || Index >= GBAHouseGrid::MaxItems) return;
+
+		if (Index < this->Count) this->Mark(this->Items[Index], false);
+		else this->Count++;
+
+		this->Items[Index] = { ID, X, Y, Direction };
+		this->Mark(this->Items[Index], true);
+	};
+
+	/* Move, Turn or Change the ID of a placed Item. */
+	void GBAHouseGrid::Move(const uint8_t Index, const uint8_t X, const uint8_t Y) {
+		if (Index < this->Count) this->Place(Index, this->Items[Index].ID, X, Y, this->Items[Index].Direction);
+	};
+	void GBAHouseGrid::Turn(const uint8_t Index, const GBAHouseItemDirection Direction) {
+		if (Index < this->Count) this->Place(Index, this->Items[Index].ID, this->Items[Index].X, this->Items[Index].Y, Direction);
+	};
+	void GBAHouseGrid::Change(const uint8_t Index, const uint8_t ID) {
+		if (Index < this->Count) this->Place(Index, ID, this->Items[Index].X, this->Items[Index].Y, this->Items[Index].Direction);
+	};
+
+	/* Remove an Item. The Items after it move down by one, like GBAHouseItem::RemoveItem() does. */
+	void GBAHouseGrid::Remove(const uint8_t Index) {
+		if (Index >= this->Count) return;
+
+		this->Mark(this->Items[Index], false);
+		for (uint8_t Idx = Index; Idx < this->Count - 1; Idx++) this->Items[Idx] = this->Items[Idx + 1];
+		this->Count--;
+	};
+
+
+	/*
+		Get the footprint of an Item.
+
+		const uint8_t ID: The Item ID.
+		const GBAHouseItemDirection Direction: The Direction. Down and Up swap width and height.
+	*/
+	GBAItemFootprint GBAHouseGrid::Footprint(const uint8_t ID, const GBAHouseItemDirection Direction) {
+		const GBAItemFootprint Size = GBAHouseGrid::Footprints[ID];
+
+		if (Direction == GBAHouseItemDirection::Down || Direction == GBAHouseItemDirection::Up) return { Size.Height, Size.Width, Size.Known };
+		return Size;
+	};
+
+	/*
+		Set the footprint of an Item for all grids. Grids which are already built don't change.
+
+		const uint8_t ID: The Item ID.
+		const uint8_t Width: The width in tiles, facing Right / Left.
+		const uint8_t Height: The height in tiles, facing Right / Left.
+	*/
+	void GBAHouseGrid::SetFootprint(const uint8_t ID, const uint8_t Width, const uint8_t Height) {
+		GBAHouseGrid::Footprints[ID] = {
+			std::max<uint8_t>(1, std::min<uint8_t>(GBAHouseGrid::MaxSize, Width)),
+			std::max<uint8_t>(1, std::min<uint8_t>(GBAHouseGrid::MaxSize, Height)),
+			true
+		};
+	};
+};
\ No newline at end of file
@@ -24,6 +24,7 @@
 *         reasonable ways as different from the original version.
 */
 
+#include "GBAHouseGrid.hpp"
 #include "GBAHouseItem.hpp"
 #include "../shared/SavUtils.hpp"
 
@@ -43,6 +44,39 @@ namespace S2Core {
 		if (this->Count() == 0) return;
 
 		SavUtils::Write<uint8_t>(this->Offs + 0x1 + (std::min<uint8_t>(this->Count() - 1, Index) * 0x6), V);
+		this->Sync(std::min<uint8_t>(this->Count() - 1, Index));
+	};
+
+	/*
+		Get the IDs of all Items at once.
+
+		uint8_t *Out: A Buffer for up to 12 IDs.
+
+		Returns the amount of IDs written to Out.
+	*/
+	uint8_t GBAHouseItem::IDs(uint8_t *Out) const {
+		const uint8_t CT = std::min<uint8_t>(0xC, this->Count());
+		if (!CT || !SavUtils::ReadArray<uint8_t>(this->Offs + 0x1, Out, CT, 0x6)) return 0;
+
+		return CT;
+	};
+
+	/*
+		Keep a GBAHouseGrid up to date with the changes done through this class.
+
+		GBAHouseGrid *Grid: The grid, or nullptr to detach. It is built from the current Items right away.
+
+		Only changes through this instance reach the grid. Changes through another GBAHouseItem of the same House
+		(such as a new one from GBASlot::House()->Items()) or any other Sav write leave it stale, so call Build() again after those.
+	*/
+	void GBAHouseItem::Attach(GBAHouseGrid *Grid) {
+		this->Grid = Grid;
+		if (this->Grid) this->Grid->Build(*this);
+	};
+
+	/* Copy an Item from the Sav to the attached grid. It's read back, so writes which didn't happen (read-only) don't show up. */
+	void GBAHouseItem::Sync(const uint8_t Index) {
+		if (this->Grid) this->Grid->Place(Index, this->ID(Index), this->XPos(Index), this->YPos(Index), this->Direction(Index));
 	};
 
 	/* Get and Set the Item Flag. */
@@ -79,6 +113,7 @@ namespace S2Core {
 		if (this->Count() == 0) return;
 
 		SavUtils::Write<uint8_t>(this->Offs + 0x4 + (std::min<uint8_t>(this->Count() - 1, Index) * 0x6), V);
+		this->Sync(std::min<uint8_t>(this->Count() - 1, Index));
 	};
 
 	/* Get and Set the Y Position of the Item. */
@@ -91,6 +126,7 @@ namespace S2Core {
 		if (this->Count() == 0) return;
 
 		SavUtils::Write<uint8_t>(this->Offs + 0x5 + (std::min<uint8_t>(this->Count() - 1, Index) * 0x6), V);
+		this->Sync(std::min<uint8_t>(this->Count() - 1, Index));
 	};
 
 	/* Get and Set the Item Direction. */
@@ -138,6 +174,8 @@ namespace S2Core {
 			case GBAHouseItemDirection::Invalid:
 				break;
 		}
+
+		this->Sync(std::min<uint8_t>(this->Count() - 1, Index));
 	};
 
 	/*
@@ -151,6 +189,7 @@ namespace S2Core {
 	*/
 	bool GBAHouseItem::AddItem(const uint8_t ID, const uint8_t Flag, const uint8_t UseCount, const uint8_t XPos, const uint8_t YPos, const GBAHouseItemDirection Direction) {
 		if (this->Count() == 0xC) return false; // Not allowed to add more than 0xC / 12 Items.
+		if (SavUtils::Sav->GetReadOnly()) return false;
 
 		const uint8_t CT = this->Count();
 		this->Count(CT + 0x1);
@@ -168,6 +207,9 @@ namespace S2Core {
 			0xF26 - (this->Count() * 6)
 		);
 
+		SavUtils::Sav->MarkDirty((this->Offs + 0x1) + (this->Count() * 0x6), 0xF26 - (this->Count() * 6));
+		S2CORE_STAT(ItemShiftBytes, 0xF26 - (this->Count() * 6));
+
 		/* Set Item Data. */
 		this->ID(CT, ID);
 		this->Flag(CT, Flag);
@@ -175,6 +217,7 @@ namespace S2Core {
 		this->XPos(CT, XPos);
 		this->YPos(CT, YPos);
 		this->Direction(CT, Direction);
+		this->Sync(CT);
 
 		return true;
 	};
@@ -185,6 +228,7 @@ namespace S2Core {
 	*/
 	bool GBAHouseItem::RemoveItem(const uint8_t Index) {
 		if ((this->Count() == 0) || (this->Count() - 1 < Index)) return false; // Nanana, Index and or Count is not good.
+		if (SavUtils::Sav->GetReadOnly()) return false;
 
 		this->Count(this->Count() - 0x1);
 
@@ -201,6 +245,10 @@ namespace S2Core {
 			0xF26 - (this->Count() * 6)
 		);
 
+		SavUtils::Sav->MarkDirty((this->Offs + 0x1) + (Index * 0x6), 0xF26 - (this->Count() * 6));
+		S2CORE_STAT(ItemShiftBytes, 0xF26 - (this->Count() * 6));
+		if (this->Grid) this->Grid->Remove(Index);
+
 		return true;
 	};
 };
\ No newline at end of file
@@ -39,9 +39,12 @@ namespace S2Core {
 		SavUtils::Write<uint8_t>(this->Offs + 0x1 + (std::min<uint8_t>(5, Index) * 0x3), V);
 
 		/* Update Item Count. */
+		uint8_t IDs[6];
+		if (!SavUtils::ReadArray<uint8_t>(this->Offs + 0x1, IDs, 6, 0x3)) return;
+
 		uint8_t Amount = 0;
 		for (uint8_t Idx = 0; Idx < 6; Idx++) {
-			if (this->ID(Idx) != 0xE6) Amount++; // If not 0xE6 (Empty Item), increase count.
+			if (IDs[Idx] != 0xE6) Amount++; // If not 0xE6 (Empty Item), increase count.
 		}
 
 		if (this->Count() != Amount) this->Count(Amount);
@@ -26,7 +26,9 @@
 
 #include "GBASlot.hpp"
 #include "../shared/Checksum.hpp"
+#include "../shared/SavTransfer.hpp"
 #include "../shared/SavUtils.hpp"
+#include "../shared/SavView.hpp"
 
 
 namespace S2Core {
@@ -55,72 +57,124 @@ namespace S2Core {
 	std::string GBASlot::Name() const { return SavUtils::ReadString(this->Offs + 0xD, 0x8); };
 	void GBASlot::Name(const std::string &V) { SavUtils::WriteString(this->Offs + 0xD, 0x8, V); };
 
-	/* Get and Set Hairstyle. */
-	uint8_t GBASlot::Hairstyle() const { return SavUtils::ReadBits(this->Offs + 0x1D, false) / 2; };
-	void GBASlot::Hairstyle(const uint8_t V) {
-		if (V > 7) return;
+	/*
+		The Appearance is packed into the 5 bytes at 0x1D - 0x21.
+		0x1D, 0x1E, 0x20 and 0x21 keep a style in Bit 5 - 7 and a 5 bit color in Bit 0 - 4,
+		0x1F keeps the Haircolor in Bit 4 - 7 and the Hatcolor in Bit 0 - 3.
+	*/
+	typedef DataHelper::Bitfield<5, 3> StyleBits;
+	typedef DataHelper::Bitfield<0, 5> ColorBits;
+	typedef DataHelper::Bitfield<4, 4> HaircolorBits;
+	typedef DataHelper::Bitfield<0, 4> HatcolorBits;
+
+	/* Read a packed field with a single byte load. */
+	template <typename Field>
+	static uint8_t ReadPacked(const uint32_t Offs) { return Field::Get(SavUtils::Read<uint8_t>(Offs)); };
+
+	/* Write a packed field with a single byte load and store, keeping the other field of the byte intact. */
+	template <typename Field>
+	static void WritePacked(const uint32_t Offs, const uint8_t V) {
+		if (V > Field::Max) return;
 
-		SavUtils::WriteBits(this->Offs + 0x1D, false, (V * 2) + (this->Shirtcolor3() > 15 ? 0x1 : 0x0));
+		SavUtils::Write<uint8_t>(Offs, Field::Set(SavUtils::Read<uint8_t>(Offs), V));
 	};
 
+	/* Get and Set Hairstyle. */
+	uint8_t GBASlot::Hairstyle() const { return ReadPacked<StyleBits>(this->Offs + 0x1D); };
+	void GBASlot::Hairstyle(const uint8_t V) { WritePacked<StyleBits>(this->Offs + 0x1D, V); };
+
 	/* Get and Set third Shirtcolor (Long Sleeves). */
-	uint8_t GBASlot::Shirtcolor3() const { return ((SavUtils::ReadBits(this->Offs + 0x1D, false) % 2 == 1) ? 16 : 0) + SavUtils::ReadBits(this->Offs + 0x1D, true); };
-	void GBASlot::Shirtcolor3(const uint8_t V) {
-		SavUtils::WriteBits(this->Offs + 0x1D, true, ((V > 15) ? V - 16 : V));
-		SavUtils::WriteBits(this->Offs + 0x1D, false, (this->Hairstyle() * 2) + (V > 15 ? 0x1 : 0x0)); // Refresh Hairstyle as well.
-	};
+	uint8_t GBASlot::Shirtcolor3() const { return ReadPacked<ColorBits>(this->Offs + 0x1D); };
+	void GBASlot::Shirtcolor3(const uint8_t V) { WritePacked<ColorBits>(this->Offs + 0x1D, V); };
 
 	/* Get and Set Tan / Skin color. */
-	uint8_t GBASlot::Tan() const { return SavUtils::ReadBits(this->Offs + 0x1E, false) / 2; };
+	uint8_t GBASlot::Tan() const { return ReadPacked<StyleBits>(this->Offs + 0x1E); };
 	void GBASlot::Tan(const uint8_t V) {
 		if (V > 5) return;
 
-		SavUtils::WriteBits(this->Offs + 0x1E, false, (V * 2) + (this->Shirtcolor2() > 15 ? 0x1 : 0x0));
+		WritePacked<StyleBits>(this->Offs + 0x1E, V);
 	};
 
 	/* Get and Set second Shirtcolor (Short Sleeves). */
-	uint8_t GBASlot::Shirtcolor2() const { return ((SavUtils::ReadBits(this->Offs + 0x1E, false) % 2 == 1) ? 16 : 0) + SavUtils::ReadBits(this->Offs + 0x1E, true); };
-	void GBASlot::Shirtcolor2(const uint8_t V) {
-		SavUtils::WriteBits(this->Offs + 0x1E, true, ((V > 15) ? V - 16 : V));
-		SavUtils::WriteBits(this->Offs + 0x1E, false, (SavUtils::ReadBits(this->Offs + 0x1E, false) * 2) + (V > 15 ? 0x1 : 0x0)); // Refresh Tan as well.
-	};
+	uint8_t GBASlot::Shirtcolor2() const { return ReadPacked<ColorBits>(this->Offs + 0x1E); };
+	void GBASlot::Shirtcolor2(const uint8_t V) { WritePacked<ColorBits>(this->Offs + 0x1E, V); };
 
 	/* Get and Set Haircolor. */
-	uint8_t GBASlot::Haircolor() const { return SavUtils::ReadBits(this->Offs + 0x1F, false); };
-	void GBASlot::Haircolor(const uint8_t V) { SavUtils::WriteBits(this->Offs + 0x1F, false, V); };
+	uint8_t GBASlot::Haircolor() const { return ReadPacked<HaircolorBits>(this->Offs + 0x1F); };
+	void GBASlot::Haircolor(const uint8_t V) { WritePacked<HaircolorBits>(this->Offs + 0x1F, V); };
 
 	/* Get the Hatcolor. NOTE: Is also shoe color. */
-	uint8_t GBASlot::Hatcolor() const { return SavUtils::ReadBits(this->Offs + 0x1F, true); };
-	void GBASlot::Hatcolor(const uint8_t V) { SavUtils::WriteBits(this->Offs + 0x1F, true, V); };
+	uint8_t GBASlot::Hatcolor() const { return ReadPacked<HatcolorBits>(this->Offs + 0x1F); };
+	void GBASlot::Hatcolor(const uint8_t V) { WritePacked<HatcolorBits>(this->Offs + 0x1F, V); };
 
 	/* Get and Set Shirt Type. */
-	uint8_t GBASlot::Shirt() const { return SavUtils::ReadBits(this->Offs + 0x20, false) / 2; };
+	uint8_t GBASlot::Shirt() const { return ReadPacked<StyleBits>(this->Offs + 0x20); };
 	void GBASlot::Shirt(const uint8_t V) {
 		if (V > 5) return;
 
-		SavUtils::WriteBits(this->Offs + 0x20, false, (V * 2) + (this->Shirtcolor1() > 15 ? 0x1 : 0x0));
+		WritePacked<StyleBits>(this->Offs + 0x20, V);
 	};
 
 	/* Get and Set first Shirtcolor (Body). */
-	uint8_t GBASlot::Shirtcolor1() const { return ((SavUtils::ReadBits(this->Offs + 0x20, false) % 2 == 1) ? 16 : 0) + SavUtils::ReadBits(this->Offs + 0x20, true); };
-	void GBASlot::Shirtcolor1(const uint8_t V) {
-		SavUtils::WriteBits(this->Offs + 0x20, true, ((V > 15) ? V - 16 : V));
-		SavUtils::WriteBits(this->Offs + 0x20, false, (SavUtils::ReadBits(this->Offs + 0x20, false) * 2) + (V > 15 ? 0x1 : 0x0)); // Refresh Shirt as well.
-	};
+	uint8_t GBASlot::Shirtcolor1() const { return ReadPacked<ColorBits>(this->Offs + 0x20); };
+	void GBASlot::Shirtcolor1(const uint8_t V) { WritePacked<ColorBits>(this->Offs + 0x20, V); };
 
 	/* Get and Set Pants. */
-	uint8_t GBASlot::Pants() const { return SavUtils::ReadBits(this->Offs + 0x21, false) / 2; };
+	uint8_t GBASlot::Pants() const { return ReadPacked<StyleBits>(this->Offs + 0x21); };
 	void GBASlot::Pants(const uint8_t V) {
 		if (V > 1) return;
 
-		SavUtils::WriteBits(this->Offs + 0x21, false, (V * 2) + (this->Pantscolor() > 15 ? 0x1 : 0x0));
+		WritePacked<StyleBits>(this->Offs + 0x21, V);
 	};
 
 	/* Get and Set Pantscolor. */
-	uint8_t GBASlot::Pantscolor() const { return ((SavUtils::ReadBits(this->Offs + 0x21, false) % 2 == 1) ? 16 : 0) + SavUtils::ReadBits(this->Offs + 0x21, true); };
-	void GBASlot::Pantscolor(const uint8_t V) {
-		SavUtils::WriteBits(this->Offs + 0x21, true, ((V > 15) ? V - 16 : V));
-		SavUtils::WriteBits(this->Offs + 0x21, false, (this->Pants() * 2) + (V > 15 ? 0x1 : 0x0)); // Refresh Pants as well.
+	uint8_t GBASlot::Pantscolor() const { return ReadPacked<ColorBits>(this->Offs + 0x21); };
+	void GBASlot::Pantscolor(const uint8_t V) { WritePacked<ColorBits>(this->Offs + 0x21, V); };
+
+	/* Get the whole Appearance in one pass. */
+	GBAAppearance GBASlot::Appearance() const {
+		GBAAppearance Res;
+		const SavView View(this->Offs + 0x1D, 0x5);
+		if (!View.Valid()) return Res;
+
+		uint8_t Packed[5];
+		for (uint8_t Idx = 0; Idx < 5; Idx++) Packed[Idx] = View.Read<uint8_t>(Idx);
+
+		Res.Hairstyle = StyleBits::Get(Packed[0]); Res.Shirtcolor3 = ColorBits::Get(Packed[0]);
+		Res.Tan = StyleBits::Get(Packed[1]); Res.Shirtcolor2 = ColorBits::Get(Packed[1]);
+		Res.Haircolor = HaircolorBits::Get(Packed[2]); Res.Hatcolor = HatcolorBits::Get(Packed[2]);
+		Res.Shirt = StyleBits::Get(Packed[3]); Res.Shirtcolor1 = ColorBits::Get(Packed[3]);
+		Res.Pants = StyleBits::Get(Packed[4]); Res.Pantscolor = ColorBits::Get(Packed[4]);
+		return Res;
+	};
+
+	/*
+		Set the whole Appearance in one pass.
+		Out of range fields are skipped like the single setters do, the rest gets applied.
+
+		const GBAAppearance &V: The Appearance to set.
+	*/
+	void GBASlot::Appearance(const GBAAppearance &V) {
+		SavEditView View(this->Offs + 0x1D, 0x5);
+		if (!View.Valid()) return;
+
+		uint8_t Orig[5], Packed[5];
+		for (uint8_t Idx = 0; Idx < 5; Idx++) Orig[Idx] = Packed[Idx] = View.Read<uint8_t>(Idx);
+
+		if (V.Hairstyle <= 7) Packed[0] = StyleBits::Set(Packed[0], V.Hairstyle);
+		if (V.Shirtcolor3 <= ColorBits::Max) Packed[0] = ColorBits::Set(Packed[0], V.Shirtcolor3);
+		if (V.Tan <= 5) Packed[1] = StyleBits::Set(Packed[1], V.Tan);
+		if (V.Shirtcolor2 <= ColorBits::Max) Packed[1] = ColorBits::Set(Packed[1], V.Shirtcolor2);
+		if (V.Haircolor <= HaircolorBits::Max) Packed[2] = HaircolorBits::Set(Packed[2], V.Haircolor);
+		if (V.Hatcolor <= HatcolorBits::Max) Packed[2] = HatcolorBits::Set(Packed[2], V.Hatcolor);
+		if (V.Shirt <= 5) Packed[3] = StyleBits::Set(Packed[3], V.Shirt);
+		if (V.Shirtcolor1 <= ColorBits::Max) Packed[3] = ColorBits::Set(Packed[3], V.Shirtcolor1);
+		if (V.Pants <= 1) Packed[4] = StyleBits::Set(Packed[4], V.Pants);
+		if (V.Pantscolor <= ColorBits::Max) Packed[4] = ColorBits::Set(Packed[4], V.Pantscolor);
+
+		for (uint8_t Idx = 0; Idx < 5; Idx++) {
+			if (Packed[Idx] != Orig[Idx]) View.Write<uint8_t>(Idx, Packed[Idx]);
+		}
 	};
 
 	/* Get and Set the Confidence Skill Points. */
@@ -156,14 +210,14 @@ namespace S2Core {
 	void GBASlot::Aspiration(const uint8_t V) { SavUtils::Write<uint8_t>(this->Offs + 0x4B, std::min<uint8_t>(2, V)); };
 
 	/* Return some Item Groups of 6 Items each group. */
-	std::unique_ptr<GBAItem> GBASlot::PawnShop() const { return std::make_unique<GBAItem>(this->Offs + 0x4C); };
-	std::unique_ptr<GBAItem> GBASlot::Saloon() const { return std::make_unique<GBAItem>(this->Offs + 0x5F); };
-	std::unique_ptr<GBAItem> GBASlot::Skills() const { return std::make_unique<GBAItem>(this->Offs + 0x72); };
-	std::unique_ptr<GBAItem> GBASlot::Mailbox() const { return std::make_unique<GBAItem>(this->Offs + 0x98); };
-	std::unique_ptr<GBAItem> GBASlot::Inventory() const { return std::make_unique<GBAItem>(this->Offs + 0xAB); };
+	std::unique_ptr<GBAItem> GBASlot::PawnShop() const { S2CORE_STAT(ViewAllocs, 1); return std::make_unique<GBAItem>(this->Offs + 0x4C); };
+	std::unique_ptr<GBAItem> GBASlot::Saloon() const { S2CORE_STAT(ViewAllocs, 1); return std::make_unique<GBAItem>(this->Offs + 0x5F); };
+	std::unique_ptr<GBAItem> GBASlot::Skills() const { S2CORE_STAT(ViewAllocs, 1); return std::make_unique<GBAItem>(this->Offs + 0x72); };
+	std::unique_ptr<GBAItem> GBASlot::Mailbox() const { S2CORE_STAT(ViewAllocs, 1); return std::make_unique<GBAItem>(this->Offs + 0x98); };
+	std::unique_ptr<GBAItem> GBASlot::Inventory() const { S2CORE_STAT(ViewAllocs, 1); return std::make_unique<GBAItem>(this->Offs + 0xAB); };
 
 	/* Return House Items. */
-	std::unique_ptr<GBAHouse> GBASlot::House() const { return std::make_unique<GBAHouse>(this->Offs); };
+	std::unique_ptr<GBAHouse> GBASlot::House() const { S2CORE_STAT(ViewAllocs, 1); return std::make_unique<GBAHouse>(this->Offs); };
 
 	/* Get and Set Empty Chug-Chug Cola Cans Amount. */
 	uint8_t GBASlot::Cans() const { return SavUtils::Read<uint8_t>(this->Offset(0xF6)); };
@@ -199,8 +253,10 @@ namespace S2Core {
 
 	/* Get the Current Episode you are in. */
 	uint8_t GBASlot::CurrentEpisode() const {
+		const uint8_t Episode = SavUtils::Read<uint8_t>(this->Offset(0x1A3));
+
 		for (uint8_t Idx = 0; Idx < 12; Idx++) {
-			if (SavUtils::Read<uint8_t>(this->Offset(0x1A3)) == this->EPVals[Idx]) return Idx;
+			if (Episode == this->EPVals[Idx]) return Idx;
 		}
 
 		return 12; // 12 -> "Unofficial Episode".
@@ -230,6 +286,7 @@ namespace S2Core {
 
 	/* Return a Minigame class Pointer. */
 	std::unique_ptr<GBAMinigame> GBASlot::Minigame(const uint8_t Game) {
+		S2CORE_STAT(ViewAllocs, 1);
 		return std::make_unique<GBAMinigame>(this->Offset(0x1AD), Game);
 	};
 
@@ -263,19 +320,169 @@ namespace S2Core {
 
 	/* Return an Episode class Pointer. */
 	std::unique_ptr<GBAEpisode> GBASlot::Episode(const uint8_t EP) const {
+		S2CORE_STAT(ViewAllocs, 1);
 		return std::make_unique<GBAEpisode>(this->Slot, EP, SavUtils::Read<uint8_t>(this->Offs + 0xD6));
 	};
 
 	/* Return a Social Move class Pointer. */
 	std::unique_ptr<GBASocialMove> GBASlot::SocialMove(const uint8_t Move) const {
+		S2CORE_STAT(ViewAllocs, 1);
 		return std::make_unique<GBASocialMove>(this->Offset(0x3EE) + (std::min<uint8_t>(14, Move)) * 0x8, Move);
 	};
 
 	/* Return a Cast class Pointer. */
 	std::unique_ptr<GBACast> GBASlot::Cast(const uint8_t CST) const {
+		S2CORE_STAT(ViewAllocs, 1);
 		return std::make_unique<GBACast>(this->Offset(0x466) + (std::min<uint8_t>(25, CST)) * 0xA, CST);
 	};
 
+	/*
+		Read all Episodes at once.
+
+		GBAEpisodeTable &Out: Where to store the Episodes.
+
+		Returns false if the Sav couldn't be read, Out is untouched then.
+	*/
+	bool GBASlot::ReadEpisodes(GBAEpisodeTable &Out) const {
+		const uint32_t Base = this->Offs + (std::min<uint8_t>(10, SavUtils::Read<uint8_t>(this->Offs + 0xD6)) * 0x6); // Same as GBAEpisode.
+		const SavView View(Base + 0x104, 0x6F); // 0x104 - 0x172, the first to the last Episode.
+		if (!View.Valid()) return false;
+
+		for (uint8_t EP = 0; EP < GBAEpisodeTable::Count; EP++) {
+			const uint32_t Pos = GBAEpisode::EPOffs[EP] - 0x104;
+
+			for (uint8_t Category = 0; Category < 4; Category++) Out.Rating[Category][EP] = View.Read<uint8_t>(Pos + Category);
+			Out.State[EP] = View.Read<uint8_t>(Pos + 0x4);
+		}
+
+		return true;
+	};
+
+	/*
+		Write all Episodes at once, with the same limits as GBAEpisode.
+
+		const GBAEpisodeTable &V: The Episodes.
+	*/
+	void GBASlot::WriteEpisodes(const GBAEpisodeTable &V) {
+		const uint32_t Base = this->Offs + (std::min<uint8_t>(10, SavUtils::Read<uint8_t>(this->Offs + 0xD6)) * 0x6);
+		SavEditView View(Base + 0x104, 0x6F);
+		if (!View.Valid()) return;
+
+		for (uint8_t EP = 0; EP < GBAEpisodeTable::Count; EP++) {
+			const uint32_t Pos = GBAEpisode::EPOffs[EP] - 0x104;
+
+			for (uint8_t Category = 0; Category < 4; Category++) View.Write<uint8_t>(Pos + Category, std::min<uint8_t>(25, V.Rating[Category][EP]));
+			View.Write<uint8_t>(Pos + 0x4, V.State[EP]);
+		}
+	};
+
+	/*
+		Read all Social Moves at once.
+
+		GBASocialMoveTable &Out: Where to store the Social Moves.
+
+		Returns false if the Sav couldn't be read, Out is untouched then.
+	*/
+	bool GBASlot::ReadSocialMoves(GBASocialMoveTable &Out) const {
+		const SavView View(this->Offset(0x3EE), GBASocialMoveTable::Count * 0x8);
+		if (!View.Valid()) return false;
+
+		for (uint8_t Move = 0; Move < GBASocialMoveTable::Count; Move++) {
+			Out.Flag[Move] = (SocialMoveFlag)View.Read<uint8_t>((Move * 0x8));
+			Out.Level[Move] = View.Read<uint8_t>((Move * 0x8) + 0x4);
+			Out.BlockedHours[Move] = View.Read<uint8_t>((Move * 0x8) + 0x6);
+		}
+
+		return true;
+	};
+
+	/*
+		Write all Social Moves at once, with the same limits as GBASocialMove.
+
+		const GBASocialMoveTable &V: The Social Moves.
+	*/
+	void GBASlot::WriteSocialMoves(const GBASocialMoveTable &V) {
+		SavEditView View(this->Offset(0x3EE), GBASocialMoveTable::Count * 0x8);
+		if (!View.Valid()) return;
+
+		for (uint8_t Move = 0; Move < GBASocialMoveTable::Count; Move++) {
+			View.Write<uint8_t>((Move * 0x8), (uint8_t)V.Flag[Move]);
+			View.Write<uint8_t>((Move * 0x8) + 0x4, std::min<uint8_t>(3, V.Level[Move]));
+			View.Write<uint8_t>((Move * 0x8) + 0x6, std::min<uint8_t>(3, V.BlockedHours[Move]));
+		}
+	};
+
+	/*
+		Read all Casts at once.
+
+		GBACastTable &Out: Where to store the Casts.
+
+		Returns false if the Sav couldn't be read, Out is untouched then.
+	*/
+	bool GBASlot::ReadCasts(GBACastTable &Out) const {
+		const SavView View(this->Offset(0x466), GBACastTable::Count * 0xA);
+		if (!View.Valid()) return false;
+
+		for (uint8_t CST = 0; CST < GBACastTable::Count; CST++) {
+			const uint32_t Pos = CST * 0xA;
+
+			Out.Friendly[CST] = View.Read<uint8_t>(Pos);
+			Out.Romance[CST] = View.Read<uint8_t>(Pos + 0x1);
+			Out.Intimidate[CST] = View.Read<uint8_t>(Pos + 0x2);
+			Out.Feeling[CST] = (GBACastFeeling)View.Read<uint8_t>(Pos + 0x3);
+			Out.FeelingEffectHours[CST] = View.Read<uint8_t>(Pos + 0x6);
+			Out.RegisteredOnPhone[CST] = View.Read<uint8_t>(Pos + 0x7);
+			Out.Secret[CST] = View.Read<uint8_t>(Pos + 0x8);
+		}
+
+		return true;
+	};
+
+	/*
+		Write all Casts at once, with the same limits as GBACast.
+
+		const GBACastTable &V: The Casts.
+	*/
+	void GBASlot::WriteCasts(const GBACastTable &V) {
+		SavEditView View(this->Offset(0x466), GBACastTable::Count * 0xA);
+		if (!View.Valid()) return;
+
+		for (uint8_t CST = 0; CST < GBACastTable::Count; CST++) {
+			const uint32_t Pos = CST * 0xA;
+
+			View.Write<uint8_t>(Pos, std::min<uint8_t>(3, V.Friendly[CST]));
+			View.Write<uint8_t>(Pos + 0x1, std::min<uint8_t>(3, V.Romance[CST]));
+			View.Write<uint8_t>(Pos + 0x2, std::min<uint8_t>(3, V.Intimidate[CST]));
+			View.Write<uint8_t>(Pos + 0x3, (uint8_t)V.Feeling[CST]);
+			View.Write<uint8_t>(Pos + 0x6, V.FeelingEffectHours[CST]);
+			View.Write<uint8_t>(Pos + 0x7, V.RegisteredOnPhone[CST]);
+			View.Write<uint8_t>(Pos + 0x8, V.Secret[CST]);
+		}
+	};
+
+	/*
+		Export the Slot to a single Slot file.
+
+		Returns an empty vector if there is no Sav loaded.
+	*/
+	std::vector<uint8_t> GBASlot::Export() const {
+		if (!SavUtils::Sav) return { };
+		return SavTransfer::ExportSlot(*SavUtils::Sav, this->Slot);
+	};
+
+	/*
+		Import a single Slot file to the Slot.
+
+		const uint8_t *Data: The single Slot file.
+		const size_t Size: The size of Data.
+
+		Returns false if the file doesn't fit the Sav, or is damaged.
+	*/
+	bool GBASlot::Import(const uint8_t *Data, const size_t Size) {
+		if (!SavUtils::Sav) return false;
+		return SavTransfer::ImportSlot(*SavUtils::Sav, this->Slot, Data, Size);
+	};
+
 	/*
 		Fix the Checksum of the current Slot, if invalid.
 
@@ -28,6 +28,7 @@
 #include "../Strings.hpp"
 #include "../shared/Checksum.hpp"
 #include "../shared/SavUtils.hpp"
+#include "../shared/SavView.hpp"
 
 
 namespace S2Core {
@@ -35,8 +36,11 @@ namespace S2Core {
 		Checks, if the Painting is valid by checking it's 5 byte Identifier.
 	*/
 	bool NDSPainting::Valid() const {
+		const SavView View(this->Offs, 0x5);
+		if (!View.Valid()) return false;
+
 		for (uint8_t Idx = 0; Idx < 5; Idx++) {
-			if (SavUtils::Read<uint8_t>(this->Offs + Idx) != this->Identifier[Idx]) return false; // Invalid.
+			if (View.Read<uint8_t>(Idx) != this->Identifier[Idx]) return false; // Invalid.
 		}
 
 		return true;
@@ -66,6 +70,37 @@ namespace S2Core {
 		SavUtils::WriteBits(this->Offs + 0x14 + (Idx / 2), (Idx % 2 == 0), V);
 	};
 
+	/*
+		Read and Write all 0x600 Pixels of the Painting Image Data at once.
+
+		uint8_t *Out / const uint8_t *In: A Buffer of 0x600 Pixels, one Pixel per byte.
+	*/
+	void NDSPainting::ReadPixels(uint8_t *Out) const {
+		if (!Out) return;
+
+		const SavView View(this->Offs + 0x14, 0x300);
+		if (!View.Valid()) {
+			memset(Out, 0x0, 0x600);
+			return;
+		}
+
+		for (uint16_t Idx = 0; Idx < 0x300; Idx++) {
+			Out[(Idx * 2)] = View.ReadBits(Idx, true);
+			Out[(Idx * 2) + 1] = View.ReadBits(Idx, false);
+		}
+	};
+	void NDSPainting::WritePixels(const uint8_t *In) {
+		if (!In) return;
+
+		SavEditView View(this->Offs + 0x14, 0x300);
+		if (!View.Valid()) return;
+
+		for (uint16_t Idx = 0; Idx < 0x300; Idx++) {
+			const uint8_t Packed = (std::min<uint8_t>(0xF, In[(Idx * 2) + 1]) << 4) | std::min<uint8_t>(0xF, In[(Idx * 2)]);
+			if (View.Read<uint8_t>(Idx) != Packed) View.Write<uint8_t>(Idx, Packed);
+		}
+	};
+
 	/* Same as above, but instead of an raw index, it is being done with an X and Y Position. */
 	uint8_t NDSPainting::PixelPos(const uint8_t X, const uint8_t Y) const {
 		if (X >= 32 || Y >= 32) return 0;
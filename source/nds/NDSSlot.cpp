@@ -26,6 +26,7 @@
 
 #include "NDSSlot.hpp"
 #include "../shared/Checksum.hpp"
+#include "../shared/SavTransfer.hpp"
 #include "../shared/SavUtils.hpp"
 
 
@@ -79,18 +80,44 @@ namespace S2Core {
 	void NDSSlot::PocketCount(const uint8_t V) { SavUtils::Write<uint8_t>(this->Offs + 0xCF, std::min<uint8_t>(6, V)); };
 
 	/* Get and Set the Pocket Item IDs. */
-	uint16_t NDSSlot::PocketID(const uint8_t Index) const { return SavUtils::Read<uint16_t>(this->Offs + 0xC3 + (std::min<uint8_t>(6, Index) * 2)); };
+	uint16_t NDSSlot::PocketID(const uint8_t Index) const { return SavUtils::Read<uint16_t>(this->Offs + 0xC3 + (std::min<uint8_t>(5, Index) * 2)); };
 	void NDSSlot::PocketID(const uint8_t Index, const uint16_t V) {
-		SavUtils::Write<uint8_t>(this->Offs + 0xC3 + (std::min<uint8_t>(6, Index) * 2), V);
+		SavUtils::Write<uint16_t>(this->Offs + 0xC3 + (std::min<uint8_t>(5, Index) * 2), V);
+
+		uint16_t IDs[6];
+		if (!SavUtils::ReadArray<uint16_t>(this->Offs + 0xC3, IDs, 6)) return;
 
 		uint8_t Count = 0;
 		for (uint8_t Idx = 0; Idx < 6; Idx++) {
-			if (this->PocketID(Idx) != 0x0) Count++; // Is that the proper way? TODO: More research for actual empty IDs.
+			if (IDs[Idx] != 0x0) Count++; // Is that the proper way? TODO: More research for actual empty IDs.
 		}
 
 		this->PocketCount(Count);
 	};
 
+	/*
+		Export the Slot to a single Slot file.
+
+		Returns an empty vector if there is no Sav loaded.
+	*/
+	std::vector<uint8_t> NDSSlot::Export() const {
+		if (!SavUtils::Sav) return { };
+		return SavTransfer::ExportSlot(*SavUtils::Sav, SavUtils::Read<uint8_t>(this->Offs + 0xC));
+	};
+
+	/*
+		Import a single Slot file to the Slot.
+
+		const uint8_t *Data: The single Slot file.
+		const size_t Size: The size of Data.
+
+		Returns false if the file doesn't fit the Sav, or is damaged.
+	*/
+	bool NDSSlot::Import(const uint8_t *Data, const size_t Size) {
+		if (!SavUtils::Sav) return false;
+		return SavTransfer::ImportSlot(*SavUtils::Sav, SavUtils::Read<uint8_t>(this->Offs + 0xC), Data, Size);
+	};
+
 	/*
 		Fix the Checksum of the current Slot, if invalid.
 
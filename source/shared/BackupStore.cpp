@@ -0,0 +1,351 @@
+/*
+*   This file is part of Sim2Editor-CPPCore
+*   Copyright (C) 2020-2021 Sim2Team
+*
+*   This program is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Additional Terms 7.b and 7.c of GPLv3 apply to this file:
+*       * Requiring preservation of specified reasonable legal notices or
+*         author attributions in that material or in the Appropriate Legal
+*         Notices displayed by works containing it.
+*       * Prohibiting misrepresentation of the origin of that material,
+*         or requiring that modified versions of such material be marked in
+*         reasonable ways as different from the original version.
+*/
+
+#include "BackupStore.hpp"
+#include "Checksum.hpp"
+#include "DataHelper.hpp"
+#include "RLE.hpp"
+#include <algorithm>
+#include <ctime>
+#include <dirent.h>
+#include <mutex>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <unordered_map>
+#include <unordered_set>
+
+
+namespace S2Core {
+	static constexpr const char *Extension = ".S2B";
+	static constexpr size_t TimeLength = 25; // 'Sims2-Year.Month.Day-Hour.Minute.Second'.
+
+	/*
+		Store() skips blocks which already exist, so a Prune() running at the same time could remove them before the manifest is written.
+		Both take this lock, for all BackupStores of the process, including the background Backup writer of SavUtils.
+	*/
+	static std::mutex StoreMutex;
+
+	/* Return the file name of a block hash. */
+	static std::string BlockName(const uint64_t Hash) {
+		char Name[17];
+		snprintf(Name, sizeof(Name), "%016llx", (unsigned long long)Hash);
+		return Name;
+	};
+
+
+	/*
+		Return the directory of a SavType.
+
+		const SavType Type: The SavType.
+		const bool Create: If the directory and its 'Blocks' directory should be created, if missing.
+	*/
+	std::string BackupStore::TypePath(const SavType Type, const bool Create) const {
+		std::string Path = this->BasePath + "/Backups/";
+		if (Create) mkdir(Path.c_str(), 0777);
+
+		switch(Type) {
+			case SavType::_GBA:
+				Path += "GBA/";
+				break;
+
+			case SavType::_NDS:
+				Path += "NDS/";
+				break;
+
+			case SavType::_NONE:
+				return "";
+		}
+
+		if (Create) {
+			mkdir(Path.c_str(), 0777);
+			mkdir((Path + "Blocks/").c_str(), 0777);
+		}
+
+		return Path;
+	};
+
+
+	/*
+		Write a file through a temporary file, so that a crash never leaves a half written block or manifest behind.
+
+		const std::string &Path: The path of the file.
+		const uint8_t *Data: The data to write.
+		const size_t Size: The size of the data.
+	*/
+	bool BackupStore::WriteFile(const std::string &Path, const uint8_t *Data, const size_t Size) const {
+		const std::string Tmp = Path + ".tmp";
+		FILE *Out = fopen(Tmp.c_str(), "wb");
+		if (!Out) return false;
+
+		/* Sync before the rename, as manifests trust every block that exists. */
+		const bool Good = (fwrite(Data, 1, Size, Out) == Size && fflush(Out) == 0 && fsync(fileno(Out)) == 0);
+		if (fclose(Out) != 0 || !Good || rename(Tmp.c_str(), Path.c_str()) != 0) {
+			remove(Tmp.c_str());
+			return false;
+		}
+
+		return true;
+	};
+
+
+	/*
+		Read a whole file.
+
+		const std::string &Path: The path of the file.
+	*/
+	std::vector<uint8_t> BackupStore::ReadFile(const std::string &Path) const {
+		std::vector<uint8_t> Res;
+		FILE *In = fopen(Path.c_str(), "rb");
+		if (!In) return Res;
+
+		fseek(In, 0, SEEK_END);
+		const long Size = ftell(In);
+		fseek(In, 0, SEEK_SET);
+
+		if (Size > 0) {
+			Res.resize(Size);
+			if (fread(Res.data(), 1, Size, In) != (size_t)Size) Res.clear();
+		}
+
+		fclose(In);
+		return Res;
+	};
+
+
+	/*
+		Store a Backup.
+
+		const uint8_t *Data: The Sav data.
+		const uint32_t Size: The size of the Sav data.
+		const SavType Type: The SavType.
+		const bool Compress: If blocks should be RLE compressed, if that makes them smaller.
+
+		Returns the name of the Backup, or an empty string on failure.
+	*/
+	std::string BackupStore::Store(const uint8_t *Data, const uint32_t Size, const SavType Type, const bool Compress) {
+		if (!Data || !Size) return "";
+
+		const std::string Path = this->TypePath(Type, true);
+		if (Path == "") return "";
+
+		std::lock_guard<std::mutex> Lock(StoreMutex);
+		const uint32_t Blocks = (Size + this->BlockSize - 1) / this->BlockSize;
+		std::vector<uint8_t> Manifest(0x14 + Blocks * 0x8, 0x0);
+		memcpy(Manifest.data(), this->Magic, 4);
+		Manifest[0x4] = this->Version;
+		Manifest[0x5] = (uint8_t)Type;
+		DataHelper::Write<uint32_t>(Manifest.data(), 0x8, Size);
+		DataHelper::Write<uint64_t>(Manifest.data(), 0xC, Checksum::Hash(Data, Size));
+
+		std::unordered_set<uint64_t> Done;
+		for (uint32_t Block = 0; Block < Blocks; Block++) {
+			const uint8_t *Src = Data + Block * this->BlockSize;
+			const uint32_t Length = std::min<uint32_t>(this->BlockSize, Size - Block * this->BlockSize);
+			const uint64_t Hash = Checksum::Hash(Src, Length);
+			DataHelper::Write<uint64_t>(Manifest.data(), 0x14 + Block * 0x8, Hash);
+
+			/* Only store blocks, which are not known yet. */
+			if (!Done.insert(Hash).second) continue;
+
+			const std::string BlockPath = Path + "Blocks/" + BlockName(Hash);
+			struct stat Info;
+			if (stat(BlockPath.c_str(), &Info) == 0) continue;
+
+			std::vector<uint8_t> Out = { 0x0 };
+			if (Compress) {
+				std::vector<uint8_t> Packed = RLE::Compress(Src, Length);
+
+				if (Packed.size() < Length) {
+					Out[0] = 0x1;
+					Out.insert(Out.end(), Packed.begin(), Packed.end());
+				}
+			}
+
+			if (Out[0] == 0x0) Out.insert(Out.end(), Src, Src + Length);
+			if (!this->WriteFile(BlockPath, Out.data(), Out.size())) return "";
+		}
+
+		/* Fetch Time there. */
+		time_t Rawtime;
+		struct tm TimeInfo;
+		char TimeBuffer[80];
+		time(&Rawtime);
+		localtime_r(&Rawtime, &TimeInfo); // Backups get written from the background writer as well.
+		strftime(TimeBuffer, sizeof(TimeBuffer),"%Y.%m.%d-%H.%M.%S", &TimeInfo); // Get the Time as String.
+
+		/* Multiple Backups within the same second get a suffix. */
+		std::string Name = "Sims2-" + std::string(TimeBuffer);
+		struct stat Info;
+		for (uint32_t Idx = 1; stat((Path + Name + Extension).c_str(), &Info) == 0; Idx++) {
+			Name = "Sims2-" + std::string(TimeBuffer) + "-" + std::to_string(Idx);
+		}
+
+		if (!this->WriteFile(Path + Name + Extension, Manifest.data(), Manifest.size())) return "";
+		return Name;
+	};
+
+
+	/*
+		Return the names of all Backups of a SavType, oldest first.
+
+		const SavType Type: The SavType.
+	*/
+	std::vector<std::string> BackupStore::List(const SavType Type) const {
+		std::vector<std::string> Res;
+
+		const std::string Path = this->TypePath(Type);
+		if (Path == "") return Res;
+
+		DIR *Dir = opendir(Path.c_str());
+		if (!Dir) return Res;
+
+		const size_t ExtLength = strlen(Extension);
+		while (const struct dirent *Entry = readdir(Dir)) {
+			const std::string Name = Entry->d_name;
+
+			if (Name.size() > ExtLength && Name.compare(Name.size() - ExtLength, ExtLength, Extension) == 0) {
+				Res.push_back(Name.substr(0, Name.size() - ExtLength));
+			}
+		}
+
+		closedir(Dir);
+
+		/* The names are timestamps, so sorting them sorts by age. Suffixes of the same second sort by their number. */
+		std::sort(Res.begin(), Res.end(), [](const std::string &A, const std::string &B) {
+			const int Time = A.compare(0, TimeLength, B, 0, TimeLength);
+			if (Time != 0) return Time < 0;
+
+			return (A.size() != B.size()) ? A.size() < B.size() : A < B;
+		});
+
+		return Res;
+	};
+
+
+	/*
+		Restore a Backup.
+
+		const std::string &Name: The name of the Backup, as returned by Store() or List().
+		const SavType Type: The SavType.
+		uint32_t &Size: Where to store the size of the restored Sav.
+
+		Returns the Sav data, or nullptr if the Backup is missing or damaged.
+	*/
+	std::unique_ptr<uint8_t[]> BackupStore::Restore(const std::string &Name, const SavType Type, uint32_t &Size) const {
+		Size = 0;
+
+		const std::string Path = this->TypePath(Type);
+		if (Path == "") return nullptr;
+
+		const std::vector<uint8_t> Manifest = this->ReadFile(Path + Name + Extension);
+		if (Manifest.size() < 0x14 || memcmp(Manifest.data(), this->Magic, 4) || Manifest[0x4] != this->Version || Manifest[0x5] != (uint8_t)Type) return nullptr;
+
+		const uint32_t ImageSize = DataHelper::Read<uint32_t>(Manifest.data(), 0x8);
+		const uint32_t Blocks = (ImageSize + this->BlockSize - 1) / this->BlockSize;
+		if (!ImageSize || Manifest.size() != 0x14 + (size_t)Blocks * 0x8) return nullptr;
+
+		std::unique_ptr<uint8_t[]> Data = std::make_unique<uint8_t[]>(ImageSize);
+		std::unordered_map<uint64_t, uint32_t> Restored; // Hash -> Block, so repeated blocks are copied instead of read again.
+
+		for (uint32_t Block = 0; Block < Blocks; Block++) {
+			uint8_t *Dst = Data.get() + Block * this->BlockSize;
+			const uint32_t Length = std::min<uint32_t>(this->BlockSize, ImageSize - Block * this->BlockSize);
+			const uint64_t Hash = DataHelper::Read<uint64_t>(Manifest.data(), 0x14 + Block * 0x8);
+
+			auto It = Restored.find(Hash);
+			if (It != Restored.end()) {
+				memcpy(Dst, Data.get() + It->second * this->BlockSize, Length);
+				continue;
+			}
+
+			const std::vector<uint8_t> Stored = this->ReadFile(Path + "Blocks/" + BlockName(Hash));
+			if (Stored.empty()) return nullptr;
+
+			if (Stored[0] == 0x1) {
+				if (!RLE::Decompress(Stored.data() + 1, Stored.size() - 1, Dst, Length)) return nullptr;
+
+			} else {
+				if (Stored[0] != 0x0 || Stored.size() - 1 != Length) return nullptr;
+				memcpy(Dst, Stored.data() + 1, Length);
+			}
+
+			Restored[Hash] = Block;
+		}
+
+		if (Checksum::Hash(Data.get(), ImageSize) != DataHelper::Read<uint64_t>(Manifest.data(), 0xC)) return nullptr;
+
+		Size = ImageSize;
+		return Data;
+	};
+
+
+	/*
+		Remove all but the newest Backups of a SavType, and all blocks no remaining Backup uses.
+		Safe against Store() calls of the same process, including the background Backup writer.
+
+		const SavType Type: The SavType.
+		const uint32_t Keep: How many Backups to keep.
+
+		Returns the amount of removed Backups.
+	*/
+	uint32_t BackupStore::Prune(const SavType Type, const uint32_t Keep) {
+		const std::string Path = this->TypePath(Type);
+		if (Path == "") return 0;
+
+		std::lock_guard<std::mutex> Lock(StoreMutex); // See StoreMutex.
+		const std::vector<std::string> Backups = this->List(Type);
+		uint32_t Removed = 0;
+
+		std::unordered_set<std::string> Used;
+		for (size_t Idx = 0; Idx < Backups.size(); Idx++) {
+			if (Idx + Keep < Backups.size()) {
+				if (remove((Path + Backups[Idx] + Extension).c_str()) == 0) Removed++;
+				continue;
+			}
+
+			const std::vector<uint8_t> Manifest = this->ReadFile(Path + Backups[Idx] + Extension);
+			for (size_t Offs = 0x14; Offs + 0x8 <= Manifest.size(); Offs += 0x8) {
+				Used.insert(BlockName(DataHelper::Read<uint64_t>(Manifest.data(), Offs)));
+			}
+		}
+
+		if (!Removed) return 0;
+
+		DIR *Dir = opendir((Path + "Blocks/").c_str());
+		if (!Dir) return Removed;
+
+		std::vector<std::string> Unused;
+		while (const struct dirent *Entry = readdir(Dir)) {
+			const std::string Name = Entry->d_name;
+			if (Name.size() == 16 && !Used.count(Name)) Unused.push_back(Name);
+		}
+
+		closedir(Dir);
+
+		for (const std::string &Name : Unused) remove((Path + "Blocks/" + Name).c_str());
+		return Removed;
+	};
+};
\ No newline at end of file
@@ -25,6 +25,7 @@
 */
 
 #include "Checksum.hpp"
+#include "SavStats.hpp"
 
 
 namespace S2Core {
@@ -41,6 +42,9 @@ namespace S2Core {
 		uint8_t Byte1 = 0, Byte2 = 0;
 		bool Skip = false;
 
+		S2CORE_STAT(ChecksumRegions, 1);
+		S2CORE_STAT(ChecksumBytes, (EndOffs > StartOffs ? (EndOffs - StartOffs) * 2 : 0));
+
 		for (uint16_t Idx = StartOffs; Idx < EndOffs; Idx++) {
 			if (!SkipOffs.empty()) { // Only do this, if it isn't empty.
 				for (uint8_t I = 0; I < SkipOffs.size(); I++) {
@@ -64,4 +68,40 @@ namespace S2Core {
 		Byte2++;
 		return (256 * (uint8_t)-Byte2) + (uint8_t)-Byte1;
 	};
+
+	/*
+		A fast 64 bit content hash, used to tell if two regions of a Sav are the same without comparing them byte by byte.
+		This is NOT what the game uses, use Calc() for that.
+
+		const uint8_t *Buffer: The Buffer to hash.
+		const uint32_t Size: The size of the Buffer.
+
+		The hash is the same on little and big endian hosts.
+	*/
+	uint64_t Checksum::Hash(const uint8_t *Buffer, const uint32_t Size) {
+		uint64_t Res = 0x9E3779B97F4A7C15 ^ Size;
+		if (!Buffer) return Res;
+
+		uint32_t Idx = 0;
+		for (; Idx + 8 <= Size; Idx += 8) {
+			uint64_t V = 0;
+			memcpy(&V, Buffer + Idx, 8);
+			#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+				V = __builtin_bswap64(V);
+			#endif
+
+			Res = (Res ^ V) * 0xBF58476D1CE4E5B9;
+			Res ^= Res >> 31;
+		}
+
+		/* The remaining bytes. */
+		for (; Idx < Size; Idx++) Res = (Res ^ Buffer[Idx]) * 0x100000001B3;
+
+		/* Final mix. */
+		Res ^= Res >> 30;
+		Res *= 0xBF58476D1CE4E5B9;
+		Res ^= Res >> 27;
+		Res *= 0x94D049BB133111EB;
+		return Res ^ (Res >> 31);
+	};
 };
\ No newline at end of file
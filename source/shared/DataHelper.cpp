@@ -25,6 +25,7 @@
 */
 
 #include "DataHelper.hpp"
+#include "StringCodec.hpp"
 
 
 namespace S2Core {
@@ -96,47 +97,36 @@ namespace S2Core {
 
 
 	/*
-		Read a string from a Buffer.
+		Read a string from a Buffer and decode it to UTF-8.
 
 		const uint8_t *Buffer: The SavBuffer.
 		const uint32_t Offs: The Offset from where to read from.
 		const uint32_t Length: The Length to read.
-
-		TODO: Japanese NDS Version String Handling.
+		const NDSSavRegion Region: The Region, for the character set. See StringCodec.
 	*/
-	const std::string DataHelper::ReadString(const uint8_t *Buffer, const uint32_t Offs, const uint32_t Length) {
+	const std::string DataHelper::ReadString(const uint8_t *Buffer, const uint32_t Offs, const uint32_t Length, const NDSSavRegion Region) {
 		if (!Buffer) return "";
 
-		std::string Str;
-		for (int Idx = 0; Idx < (int)Length; Idx++) {
-			if (Buffer[Offs + Idx] == 0x0) break; // 0x0 -> End.
-
-			Str += Buffer[Offs + Idx];
-		}
-
+		std::string Str(StringCodec::MaxUTF8(Length), '\0');
+		Str.resize(StringCodec::Decode(Buffer + Offs, Length, &Str[0], Str.size(), Region));
 		return Str;
 	};
 
 	/*
-		Write a string to a Buffer.
+		Encode an UTF-8 string and write it to a Buffer.
 
 		uint8_t *Buffer: The SavBuffer.
 		const uint32_t Offs: The offset from where to write to.
-		const uint32_t Length: The length to write.
+		const uint32_t Length: The length to write. Everything after the string is filled with 0x0.
 		const std::string &Str: The string to write.
-
-		TODO: Japanese NDS Version String Handling.
+		const NDSSavRegion Region: The Region, for the character set. See StringCodec.
 
 		Returns true if success, false if not.
 	*/
-	bool DataHelper::WriteString(uint8_t *Buffer, const uint32_t Offs, const uint32_t Length, const std::string &Str) {
+	bool DataHelper::WriteString(uint8_t *Buffer, const uint32_t Offs, const uint32_t Length, const std::string &Str, const NDSSavRegion Region) {
 		if (!Buffer) return false;
 
-		for (int Idx = 0; Idx < (int)Length; Idx++) {
-			if (Idx < (int)Str.size()) Buffer[Offs + Idx] = Str[Idx]; // The index is inside the string length, so write that.
-			else Buffer[Offs + Idx] = 0; // Index outside the string length.. so write 0.
-		}
-
+		StringCodec::Encode(Str.data(), Str.size(), Buffer + Offs, Length, Region);
 		return true;
 	};
 };
\ No newline at end of file
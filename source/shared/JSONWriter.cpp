@@ -0,0 +1,233 @@
+/*
+*   This file is part of Sim2Editor-CPPCore
+*   Copyright (C) 2020-2021 Sim2Team
+*
+*   This program is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Additional Terms 7.b and 7.c of GPLv3 apply to this file:
+*       * Requiring preservation of specified reasonable legal notices or
+*         author attributions in that material or in the Appropriate Legal
+*         Notices displayed by works containing it.
+*       * Prohibiting misrepresentation of the origin of that material,
+*         or requiring that modified versions of such material be marked in
+*         reasonable ways as different from the original version.
+*/
+
+#include "JSONWriter.hpp"
+#include <unistd.h>
+
+
+namespace S2Core {
+	/*
+		Return a Sink, which appends to a string.
+
+		std::string &Str: The string to append to. It has to outlive the JSONWriter.
+	*/
+	JSONWriter::Sink JSONWriter::StringSink(std::string &Str) {
+		return [&Str](const char *Data, const size_t Size) {
+			Str.append(Data, Size);
+			return true;
+		};
+	};
+
+
+	/*
+		Return a Sink, which writes to a file descriptor.
+
+		const int FD: The file descriptor.
+	*/
+	JSONWriter::Sink JSONWriter::FDSink(const int FD) {
+		return [FD](const char *Data, const size_t Size) {
+			size_t Done = 0;
+
+			while (Done < Size) {
+				const ssize_t Res = write(FD, Data + Done, Size - Done);
+				if (Res <= 0) return false;
+
+				Done += Res;
+			}
+
+			return true;
+		};
+	};
+
+
+	/* Hand the buffered data to the Sink. */
+	bool JSONWriter::Flush() {
+		if (this->Pos > 0 && this->Ok) this->Ok = this->Out(this->Buffer, this->Pos);
+
+		this->Pos = 0;
+		return this->Ok;
+	};
+
+
+	/* Write a single character. */
+	void JSONWriter::Put(const char C) {
+		if (this->Pos == sizeof(this->Buffer)) this->Flush();
+
+		this->Buffer[this->Pos++] = C;
+	};
+
+	/* Write multiple characters. */
+	void JSONWriter::Put(const char *Str, const size_t Length) {
+		for (size_t Done = 0; Done < Length;) {
+			if (this->Pos == sizeof(this->Buffer)) this->Flush();
+
+			const size_t Amount = std::min(Length - Done, sizeof(this->Buffer) - this->Pos);
+			memcpy(this->Buffer + this->Pos, Str + Done, Amount);
+			this->Pos += Amount;
+			Done += Amount;
+		}
+	};
+
+
+	/*
+		Write the separator and the key of the next value.
+
+		const char *Key: The key, or nullptr inside of Arrays.
+	*/
+	void JSONWriter::Key(const char *Key) {
+		const uint64_t Bit = 1ULL << std::min<uint8_t>(63, this->Depth);
+
+		if (this->HasValue & Bit) this->Put(',');
+		this->HasValue |= Bit;
+
+		if (Key) {
+			this->Escaped(Key, strlen(Key));
+			this->Put(':');
+		}
+	};
+
+
+	/*
+		Write a quoted and escaped string.
+
+		Bytes 0x80 and above, which are not part of valid UTF-8, are written as their Latin-1 code point.
+	*/
+	void JSONWriter::Escaped(const char *Str, const size_t Length) {
+		static constexpr char HexChars[] = "0123456789abcdef";
+		this->Put('"');
+
+		for (size_t Idx = 0; Idx < Length; Idx++) {
+			const uint8_t C = (uint8_t)Str[Idx];
+
+			switch(C) {
+				case '"':
+					this->Put("\\\"", 2);
+					break;
+
+				case '\\':
+					this->Put("\\\\", 2);
+					break;
+
+				case '\n':
+					this->Put("\\n", 2);
+					break;
+
+				default:
+					if (C >= 0x20 && C < 0x80) {
+						this->Put(C);
+						break;
+					}
+
+					/* Pass valid UTF-8 sequences through as is. */
+					if (C >= 0xC2 && C <= 0xF4) {
+						const uint8_t Need = (C >= 0xF0 ? 3 : (C >= 0xE0 ? 2 : 1));
+						uint8_t Got = 0;
+
+						while (Got < Need && Idx + 1 + Got < Length && ((uint8_t)Str[Idx + 1 + Got] & 0xC0) == 0x80) Got++;
+
+						if (Got == Need) {
+							this->Put(Str + Idx, Need + 1);
+							Idx += Need;
+							break;
+						}
+					}
+
+					const char Esc[6] = { '\\', 'u', '0', '0', HexChars[C >> 4], HexChars[C & 0xF] };
+					this->Put(Esc, 6);
+					break;
+			}
+		}
+
+		this->Put('"');
+	};
+
+
+	/* Begin and End an Object. */
+	void JSONWriter::BeginObject(const char *Key) {
+		this->Key(Key);
+		this->Put('{');
+		this->HasValue &= ~(1ULL << std::min<uint8_t>(63, ++this->Depth));
+	};
+	void JSONWriter::EndObject() {
+		this->Put('}');
+		if (this->Depth > 0) this->Depth--;
+	};
+
+	/* Begin and End an Array. */
+	void JSONWriter::BeginArray(const char *Key) {
+		this->Key(Key);
+		this->Put('[');
+		this->HasValue &= ~(1ULL << std::min<uint8_t>(63, ++this->Depth));
+	};
+	void JSONWriter::EndArray() {
+		this->Put(']');
+		if (this->Depth > 0) this->Depth--;
+	};
+
+
+	/* Write a Number. */
+	void JSONWriter::Number(const char *Key, const uint32_t V) {
+		char Digits[10];
+		uint8_t Count = 0;
+		uint32_t Rest = V;
+
+		do {
+			Digits[sizeof(Digits) - ++Count] = '0' + (Rest % 10);
+			Rest /= 10;
+		} while (Rest);
+
+		this->Key(Key);
+		this->Put(Digits + sizeof(Digits) - Count, Count);
+	};
+
+	/* Write a Bool. */
+	void JSONWriter::Bool(const char *Key, const bool V) {
+		this->Key(Key);
+		if (V) this->Put("true", 4);
+		else this->Put("false", 5);
+	};
+
+	/* Write a String. */
+	void JSONWriter::String(const char *Key, const char *Str, const size_t Length) {
+		this->Key(Key);
+		this->Escaped(Str, Length);
+	};
+
+	/* Write raw data as a hex String. */
+	void JSONWriter::Hex(const char *Key, const uint8_t *Data, const size_t Length) {
+		static constexpr char HexChars[] = "0123456789abcdef";
+
+		this->Key(Key);
+		this->Put('"');
+
+		for (size_t Idx = 0; Idx < Length; Idx++) {
+			this->Put(HexChars[Data[Idx] >> 4]);
+			this->Put(HexChars[Data[Idx] & 0xF]);
+		}
+
+		this->Put('"');
+	};
+};
\ No newline at end of file
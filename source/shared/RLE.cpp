@@ -0,0 +1,112 @@
+/*
+*   This file is part of Sim2Editor-CPPCore
+*   Copyright (C) 2020-2021 Sim2Team
+*
+*   This program is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Additional Terms 7.b and 7.c of GPLv3 apply to this file:
+*       * Requiring preservation of specified reasonable legal notices or
+*         author attributions in that material or in the Appropriate Legal
+*         Notices displayed by works containing it.
+*       * Prohibiting misrepresentation of the origin of that material,
+*         or requiring that modified versions of such material be marked in
+*         reasonable ways as different from the original version.
+*/
+
+#include "RLE.hpp"
+
+
+namespace S2Core {
+	/*
+		Compress a Buffer.
+
+		const uint8_t *Buffer: The Buffer to compress.
+		const uint32_t Size: The size of the Buffer.
+	*/
+	std::vector<uint8_t> RLE::Compress(const uint8_t *Buffer, const uint32_t Size) {
+		std::vector<uint8_t> Res;
+		if (!Buffer) return Res;
+
+		Res.reserve(Size / 8);
+		uint32_t Pos = 0, Literal = 0; // Literal: Start of the pending literal bytes.
+
+		const auto FlushLiterals = [&](const uint32_t End) {
+			while (Literal < End) {
+				const uint32_t Length = std::min<uint32_t>(0x80, End - Literal);
+				Res.push_back(Length - 1);
+				Res.insert(Res.end(), Buffer + Literal, Buffer + Literal + Length);
+				Literal += Length;
+			}
+		};
+
+		while (Pos < Size) {
+			uint32_t Run = 1;
+			while (Pos + Run < Size && Run < 0x81 && Buffer[Pos + Run] == Buffer[Pos]) Run++;
+
+			/* Runs of 2 only pay off between other runs, 3 always does. */
+			if (Run >= 3 || (Run == 2 && Literal == Pos)) {
+				FlushLiterals(Pos);
+				Res.push_back(0x80 + Run - 2);
+				Res.push_back(Buffer[Pos]);
+				Pos += Run;
+				Literal = Pos;
+
+			} else {
+				Pos += Run;
+			}
+		}
+
+		FlushLiterals(Size);
+		return Res;
+	};
+
+
+	/*
+		Decompress a Buffer.
+
+		const uint8_t *Buffer: The compressed Buffer.
+		const uint32_t Size: The size of the compressed Buffer.
+		uint8_t *Out: Where to decompress to.
+		const uint32_t OutSize: The expected decompressed size.
+
+		Returns false, if the Buffer is malformed or does not decompress to exactly OutSize bytes.
+	*/
+	bool RLE::Decompress(const uint8_t *Buffer, const uint32_t Size, uint8_t *Out, const uint32_t OutSize) {
+		if (!OutSize) return !Size;
+		if (!Buffer || !Out) return false;
+		uint32_t Pos = 0, OutPos = 0;
+
+		while (Pos < Size) {
+			const uint8_t Control = Buffer[Pos++];
+
+			if (Control < 0x80) {
+				const uint32_t Length = Control + 1;
+				if (Pos + Length > Size || OutPos + Length > OutSize) return false;
+
+				memcpy(Out + OutPos, Buffer + Pos, Length);
+				Pos += Length;
+				OutPos += Length;
+
+			} else {
+				const uint32_t Length = Control - 0x80 + 2;
+				if (Pos >= Size || OutPos + Length > OutSize) return false;
+
+				memset(Out + OutPos, Buffer[Pos++], Length);
+				OutPos += Length;
+			}
+		}
+
+		return OutPos == OutSize;
+	};
+};
\ No newline at end of file
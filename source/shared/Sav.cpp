@@ -27,6 +27,8 @@
 #include "Checksum.hpp"
 #include "DataHelper.hpp"
 #include "Sav.hpp"
+#include "SavStats.hpp"
+#include <istream>
 
 
 namespace S2Core {
@@ -36,22 +38,23 @@ namespace S2Core {
 		const std::string &SavFile: The SavFile path.
 	*/
 	SAV::SAV(const std::string &SavFile) : SavPath(SavFile) {
-		FILE *SFile = fopen(this->SavPath.c_str(), "r");
+		FILE *SFile = fopen(this->SavPath.c_str(), "rb");
 
 		if (SFile) {
 			fseek(SFile, 0, SEEK_END);
-			this->SavSize = ftell(SFile);
+			const long Size = ftell(SFile);
 			fseek(SFile, 0, SEEK_SET);
 
-			/*
-				0x10000 & 0x20000: GBA Savefile sizes.
-				0x40000 & 0x80000: NDS Savefile sizes.
-			*/
-			if (this->SavSize == 0x10000 || this->SavSize == 0x20000 || this->SavSize == 0x40000 || this->SavSize == 0x80000) {
-				this->SavData = std::make_unique<uint8_t[]>(this->GetSize());
-				fread(this->SavData.get(), 1, this->GetSize(), SFile);
+			if (Size >= 0x10000 && Size <= this->MaxFileSize) {
+				this->SavData = std::make_unique<uint8_t[]>(Size);
 
-				this->ValidationCheck();
+				if (fread(this->SavData.get(), 1, Size, SFile) == (size_t)Size) {
+					S2CORE_STAT(FileReadBytes, Size);
+					this->InitContainer(Size);
+
+				} else {
+					this->SavData = nullptr;
+				}
 			}
 
 			fclose(SFile);
@@ -66,16 +69,206 @@ namespace S2Core {
 		const uint32_t Size: The size of the Save Buffer.
 	*/
 	SAV::SAV(std::unique_ptr<uint8_t[]> &Data, const uint32_t Size) {
-		/*
-			0x10000 & 0x20000: GBA Savefile sizes.
-			0x40000 & 0x80000: NDS Savefile sizes.
-		*/
-		if (this->SavSize == 0x10000 || this->SavSize == 0x20000 || this->SavSize == 0x40000 || this->SavSize == 0x80000) {
+		if (Data && Size >= 0x10000 && Size <= this->MaxFileSize) {
 			this->SavData = std::move(Data);
+			this->InitContainer(Size);
+		}
+	};
+
+
+	/*
+		Work directly on caller owned memory, without copying it.
+
+		uint8_t *Data: The raw Save Buffer, which has to outlive the SAV.
+		const uint32_t Size: The size of the Save Buffer.
+	*/
+	SAV::SAV(uint8_t *Data, const uint32_t Size) {
+		if (Data && Size >= 0x10000 && Size <= this->MaxFileSize) {
+			this->External = Data;
+			this->InitContainer(Size);
+		}
+	};
+
+
+	/*
+		Detect the container of the Sav and where the actual Sav data is inside of it.
+
+		const uint32_t Size: The size of the whole file / buffer.
+
+		The Sav data is used right where it is, footers and padding stay untouched and get written back as they are.
+			- Raw: 0x10000 & 0x20000 (GBA) or 0x40000 & 0x80000 (NDS) bytes of Sav data.
+			- DeSmuME: Sav data, followed by a 0x7A byte footer ending with '|-DESMUME SAVE-|'.
+			- Padded: Sav data at the start of a bigger dump, like the ones of some flashcarts.
+	*/
+	void SAV::InitContainer(const uint32_t Size) {
+		static constexpr uint8_t DeSmuMEMagic[0x10] = { '|', '-', 'D', 'E', 'S', 'M', 'U', 'M', 'E', ' ', 'S', 'A', 'V', 'E', '-', '|' };
+		static constexpr uint32_t Sizes[4] = { 0x80000, 0x40000, 0x20000, 0x10000 };
+		const uint8_t *Base = (this->External ? this->External : this->SavData.get());
+		this->FileSize = Size;
+
+		/* Raw. */
+		if (Size == 0x10000 || Size == 0x20000 || Size == 0x40000 || Size == 0x80000) {
 			this->SavSize = Size;
+			this->ValidationCheck();
+			if (this->GetValid()) return;
+		}
+
+		/* DeSmuME. */
+		if (Size > 0x7A && !memcmp(Base + Size - sizeof(DeSmuMEMagic), DeSmuMEMagic, sizeof(DeSmuMEMagic))) {
+			this->SavSize = Size - 0x7A;
+			this->ValidationCheck();
+
+			if (this->GetValid()) {
+				this->Container = SavContainer::DeSmuME;
+				return;
+			}
+		}
+
+		/* Padded, try the biggest fitting size first. */
+		for (const uint32_t Candidate : Sizes) {
+			if (Candidate >= Size) continue;
 
+			this->SavSize = Candidate;
 			this->ValidationCheck();
+
+			if (this->GetValid()) {
+				this->Container = SavContainer::Padded;
+				return;
+			}
+		}
+
+		this->SavSize = 0;
+	};
+
+
+	/*
+		Work directly on caller owned, read only memory, without copying it. All writes get refused.
+
+		const uint8_t *Data: The raw Save Buffer, which has to outlive the SAV.
+		const uint32_t Size: The size of the Save Buffer.
+	*/
+	SAV::SAV(const uint8_t *Data, const uint32_t Size) : SAV(const_cast<uint8_t *>(Data), Size) { this->ReadOnly = true; };
+
+
+	/*
+		Read from a SavReader until a position is reached or the reader ends.
+
+		const SavReader &Reader: The reader.
+		uint8_t *Buffer: The Buffer to read into.
+		uint32_t Pos: The current position.
+		const uint32_t To: The position to read up to.
+
+		Returns the new position.
+	*/
+	static uint32_t Fill(const SavReader &Reader, uint8_t *Buffer, uint32_t Pos, const uint32_t To) {
+		while (Pos < To) {
+			const size_t Read = Reader(Buffer + Pos, To - Pos);
+			if (Read == 0 || Read > To - Pos) break;
+
+			S2CORE_STAT(FileReadBytes, Read);
+			Pos += Read;
+		}
+
+		return Pos;
+	};
+
+
+	/*
+		Load a Sav straight from a reader, like an archive entry or an upload body.
+
+		The headers are checked as soon as their bytes arrive, so anything that isn't a Sims 2 Sav gets refused after at most 0x4008 bytes.
+		The data gets read directly into the SavBuffer, which grows if there is more (a bigger Sav, a DeSmuME footer or padding),
+		up to MaxFileSize like loading from a file. The container is then detected by InitContainer() on the real length.
+
+		const SavReader &Reader: The reader.
+		const uint32_t SizeHint: The expected size of the whole file, if known, so the SavBuffer doesn't need to grow (Optional).
+	*/
+	SAV::SAV(const SavReader &Reader, const uint32_t SizeHint) {
+		if (!Reader) return;
+
+		uint32_t Capacity = ((SizeHint >= 0x10000 && SizeHint <= this->MaxFileSize) ? SizeHint : 0x10000);
+		std::unique_ptr<uint8_t[]> Data = std::make_unique<uint8_t[]>(Capacity);
+		SavType Type = SavType::_NONE;
+
+		/* GBA: The identifier is at the very start. */
+		uint32_t Pos = Fill(Reader, Data.get(), 0, 0x8);
+		if (Pos < 0x8) return;
+
+		if (!memcmp(Data.get(), this->GBAIdent, sizeof(this->GBAIdent))) Type = SavType::_GBA;
+		else {
+			/* NDS: One of the 5 possible Slots has to start with the identifier. */
+			for (uint8_t Slot = 0; Slot < 5; Slot++) {
+				const uint32_t HeaderEnd = (Slot * 0x1000) + 0x8;
+				Pos = Fill(Reader, Data.get(), Pos, HeaderEnd);
+				if (Pos < HeaderEnd) return;
+
+				if (SAV::NDSHeader(Data.get() + (Slot * 0x1000))) {
+					Type = SavType::_NDS;
+					break;
+				}
+			}
+
+			if (Type == SavType::_NONE) return;
+		}
+
+		const uint32_t MinSize = (Type == SavType::_GBA ? 0x10000 : 0x40000);
+		const auto Resize = [&](const uint32_t Size) {
+			std::unique_ptr<uint8_t[]> Resized = std::make_unique<uint8_t[]>(Size);
+			memcpy(Resized.get(), Data.get(), Pos);
+			Data = std::move(Resized);
+			Capacity = Size;
+		};
+
+		if (Capacity < MinSize) Resize(MinSize);
+
+		while (true) {
+			Pos = Fill(Reader, Data.get(), Pos, Capacity);
+			if (Pos < Capacity) break; // The end.
+
+			/* Check, if there is more. */
+			uint8_t Extra = 0;
+			if (Fill(Reader, &Extra, 0, 1) == 0) break;
+			if (Capacity == this->MaxFileSize) return; // Too big.
+
+			Resize(std::min<uint32_t>(Capacity * 2, this->MaxFileSize));
+			Data[Pos++] = Extra;
+		}
+
+		if (Pos < MinSize) return; // Too small.
+		if (Pos < Capacity) Resize(Pos); // Don't keep the unused part around.
+
+		this->SavData = std::move(Data);
+		this->InitContainer(Pos);
+	};
+
+
+	/*
+		Load a Sav straight from a stream.
+
+		std::istream &Stream: The stream.
+	*/
+	SAV::SAV(std::istream &Stream) : SAV([&Stream](uint8_t *Buffer, const size_t Size) -> size_t {
+		Stream.read((char *)Buffer, Size);
+		return Stream.gcount();
+	}) { };
+
+
+	/*
+		Return, if an NDS Slot starts with the identifier.
+
+		const uint8_t *Data: The start of the Slot.
+	*/
+	bool SAV::NDSHeader(const uint8_t *Data) {
+		for (uint8_t ID = 0; ID < 8; ID++) {
+			if (ID == 0x4) {
+				if (Data[ID] < SAV::NDSIdent[ID] || Data[ID] > SAV::NDSIdent[ID] + 2) return false;
+
+			} else if (Data[ID] != SAV::NDSIdent[ID]) {
+				return false;
+			}
 		}
+
+		return true;
 	};
 
 
@@ -83,6 +276,9 @@ namespace S2Core {
 	void SAV::ValidationCheck() {
 		if (!this->GetData()) return;
 
+		this->SavValid = false;
+		this->SType = SavType::_NONE;
+
 		switch(this->SavSize) {
 			/* Game Boy Advance. */
 			case 0x10000:
@@ -196,18 +392,107 @@ namespace S2Core {
 	};
 
 
+	/*
+		Publish the current SavBuffer as a new immutable Epoch.
+
+		Call this from the writer once an edit is complete; readers pinning the SAV through a SavSnapshot
+		afterwards see the new state, while readers still holding an older Epoch keep reading that one until they let it go.
+	*/
+	void SAV::Publish() {
+		if (!this->GetData()) return;
+
+		std::atomic_store(&this->Epoch, std::shared_ptr<const SavEpoch>(std::make_shared<SavEpoch>(this->GetData(), this->GetSize(), ++this->Generation)));
+	};
+
+
+	/*
+		Mark a range of the SavBuffer as changed.
+
+		const uint32_t Offs: The start offset.
+		const uint32_t Size: The size of the range.
+	*/
+	void SAV::MarkDirty(const uint32_t Offs, const uint32_t Size) {
+		if (!Size || Offs >= this->GetSize()) return;
+		if (this->DirtyMap.empty()) this->DirtyMap.resize(((this->GetSize() / this->DirtyGranule) + 63) / 64, 0x0);
+
+		const uint32_t Last = std::min(Offs + Size, this->GetSize()) - 1;
+		for (uint32_t Granule = Offs / this->DirtyGranule; Granule <= Last / this->DirtyGranule; Granule++) {
+			this->DirtyMap[Granule / 64] |= (1ULL << (Granule % 64));
+		}
+	};
+
+
+	/*
+		Mark a range of the SavBuffer as clean again, for example after it got restored to what is on disk.
+
+		const uint32_t Offs: The start offset.
+		const uint32_t Size: The size of the range.
+
+		NOTE: Every granule the range touches gets cleared, so the range should be DirtyGranule aligned.
+	*/
+	void SAV::ClearDirty(const uint32_t Offs, const uint32_t Size) {
+		if (this->DirtyMap.empty() || !Size || Offs >= this->GetSize()) return;
+
+		const uint32_t Last = std::min(Offs + Size, this->GetSize()) - 1;
+		for (uint32_t Granule = Offs / this->DirtyGranule; Granule <= Last / this->DirtyGranule; Granule++) {
+			this->DirtyMap[Granule / 64] &= ~(1ULL << (Granule % 64));
+		}
+	};
+
+
+	/*
+		Return, if anything of a range of the SavBuffer is dirty.
+
+		const uint32_t Offs: The start offset.
+		const uint32_t Size: The size of the range.
+	*/
+	bool SAV::Dirty(const uint32_t Offs, const uint32_t Size) const {
+		if (this->DirtyMap.empty() || !Size || Offs >= this->GetSize()) return false;
+
+		const uint32_t Last = std::min(Offs + Size, this->GetSize()) - 1;
+		for (uint32_t Granule = Offs / this->DirtyGranule; Granule <= Last / this->DirtyGranule; Granule++) {
+			if (this->DirtyMap[Granule / 64] & (1ULL << (Granule % 64))) return true;
+		}
+
+		return false;
+	};
+
+
+	/* Return the dirty ranges as offset and size pairs, adjacent granules merged. */
+	std::vector<std::pair<uint32_t, uint32_t>> SAV::DirtyRanges() const {
+		std::vector<std::pair<uint32_t, uint32_t>> Res;
+
+		for (uint32_t Word = 0; Word < this->DirtyMap.size(); Word++) {
+			if (!this->DirtyMap[Word]) continue; // Skip 64 clean granules at once.
+
+			for (uint8_t Bit = 0; Bit < 64; Bit++) {
+				if (!(this->DirtyMap[Word] & (1ULL << Bit))) continue;
+
+				const uint32_t Offs = ((Word * 64) + Bit) * this->DirtyGranule;
+				if (!Res.empty() && Res.back().first + Res.back().second == Offs) Res.back().second += this->DirtyGranule;
+				else Res.push_back({ Offs, this->DirtyGranule });
+			}
+		}
+
+		return Res;
+	};
+
+
 	/*
 		Return, wheter a Slot is valid / exist.
 
 		const uint8_t Slot: The Slot to check.
 	*/
 	bool SAV::SlotExist(const uint8_t Slot) const {
+		/* Use the pinned Epoch, if the calling thread pinned this SAV. */
+		const uint8_t *Data = (SavSnapshot::PinnedOwner() == this ? SavSnapshot::Pinned() : this->GetData());
+
 		switch(this->SType) {
 			case SavType::_GBA:
 				if (Slot < 1 || Slot > 4 || !this->GetValid()) return false;
 
 				for (uint8_t Idx = 0; Idx < 10; Idx++) {
-					if (this->GetData()[(Slot * 0x1000) + Idx] != 0) return true;
+					if (Data[(Slot * 0x1000) + Idx] != 0) return true;
 				}
 
 				return false;
@@ -233,6 +518,7 @@ namespace S2Core {
 	std::unique_ptr<GBASlot> SAV::_GBASlot(const uint8_t Slot) const {
 		if (this->SType != SavType::_GBA || !this->SlotExist(Slot)) return nullptr;
 
+		S2CORE_STAT(ViewAllocs, 1);
 		return std::make_unique<GBASlot>(Slot);
 	};
 
@@ -241,6 +527,7 @@ namespace S2Core {
 	std::unique_ptr<GBASettings> SAV::_GBASettings() const {
 		if (this->SType != SavType::_GBA) return nullptr;
 
+		S2CORE_STAT(ViewAllocs, 1);
 		return std::make_unique<GBASettings>();
 	};
 
@@ -253,6 +540,7 @@ namespace S2Core {
 	std::unique_ptr<NDSSlot> SAV::_NDSSlot(const uint8_t Slot) const {
 		if (this->SType != SavType::_NDS || !this->SlotExist(Slot)) return nullptr;
 
+		S2CORE_STAT(ViewAllocs, 1);
 		return std::make_unique<NDSSlot>(this->NDSSlots[Slot]);
 	};
 
@@ -265,6 +553,7 @@ namespace S2Core {
 	std::unique_ptr<NDSPainting> SAV::_NDSPainting(const uint8_t Idx) const {
 		if (this->SType != SavType::_NDS || Idx >= 20) return nullptr;
 
+		S2CORE_STAT(ViewAllocs, 1);
 		return std::make_unique<NDSPainting>(Idx);
 	};
 
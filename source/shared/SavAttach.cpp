@@ -0,0 +1,130 @@
+/*
+*   This file is part of Sim2Editor-CPPCore
+*   Copyright (C) 2020-2021 Sim2Team
+*
+*   This program is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Additional Terms 7.b and 7.c of GPLv3 apply to this file:
+*       * Requiring preservation of specified reasonable legal notices or
+*         author attributions in that material or in the Appropriate Legal
+*         Notices displayed by works containing it.
+*       * Prohibiting misrepresentation of the origin of that material,
+*         or requiring that modified versions of such material be marked in
+*         reasonable ways as different from the original version.
+*/
+
+#include "Checksum.hpp"
+#include "SavAttach.hpp"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+namespace S2Core {
+	/*
+		Attach to a file or shared memory object.
+
+		const std::string &Path: The file path, or the shared memory name (like '/emu-backup') if SharedMemory is true.
+		const bool Writable: If the SAV may write to the mapping (Optional). Otherwise it is read only.
+		const bool SharedMemory: If Path is a POSIX shared memory name (Optional).
+	*/
+	SavAttach::SavAttach(const std::string &Path, const bool Writable, const bool SharedMemory) {
+		const int Flags = (Writable ? O_RDWR : O_RDONLY);
+		const int FD = (SharedMemory ? shm_open(Path.c_str(), Flags, 0) : open(Path.c_str(), Flags));
+		if (FD == -1) return;
+
+		struct stat Info;
+		if (fstat(FD, &Info) == 0 && Info.st_size > 0) {
+			void *Mapped = mmap(nullptr, Info.st_size, PROT_READ | (Writable ? PROT_WRITE : 0), MAP_SHARED, FD, 0);
+
+			if (Mapped != MAP_FAILED) {
+				this->Mapping = Mapped;
+				this->MapSize = Info.st_size;
+			}
+		}
+
+		close(FD); // The mapping stays valid without it.
+		if (!this->Mapping) return;
+
+		if (Writable) this->Sav = std::make_unique<SAV>((uint8_t *)this->Mapping, this->MapSize);
+		else this->Sav = std::make_unique<SAV>((const uint8_t *)this->Mapping, this->MapSize);
+
+		if (!this->Attached()) return;
+
+		/* The initial state, so the first Poll() only reports actual changes. */
+		const uint8_t *Data = (const uint8_t *)this->Mapping;
+		for (size_t Offs = 0; Offs < this->MapSize; Offs += this->BlockSize) {
+			this->Hashes.push_back(Checksum::Hash(Data + Offs, std::min<size_t>(this->BlockSize, this->MapSize - Offs)));
+		}
+
+		for (const SavSectionRef &Ref : SavLayout::Sections(*this->Sav)) {
+			this->SectionHashes[((uint16_t)Ref.Section << 8) | Ref.Index] = Checksum::Hash(this->Sav->GetData() + Ref.Offs, Ref.Size);
+		}
+	};
+
+
+	SavAttach::~SavAttach() {
+		this->Sav = nullptr; // Before the memory goes away.
+		if (this->Mapping) munmap(this->Mapping, this->MapSize);
+	};
+
+
+	/*
+		Return the Slots and Paintings, which changed since the last Poll().
+
+		NDS Slot locations get refreshed, if the Slot area changed, as the game rotates through the physical Slots on every save.
+	*/
+	std::vector<SavSectionRef> SavAttach::Poll() {
+		std::vector<SavSectionRef> Res;
+		if (!this->Sav || this->Hashes.empty()) return Res; // Also polls a SAV, that went invalid during a write of the other side.
+
+		const uint8_t *Data = (const uint8_t *)this->Mapping;
+		std::vector<std::pair<uint32_t, uint32_t>> Changed; // Changed blocks, relative to the Sav data.
+
+		for (size_t Block = 0; Block < this->Hashes.size(); Block++) {
+			const size_t Offs = Block * this->BlockSize, Length = std::min<size_t>(this->BlockSize, this->MapSize - Offs);
+			const uint64_t Hash = Checksum::Hash(Data + Offs, Length);
+			if (Hash == this->Hashes[Block]) continue;
+
+			this->Hashes[Block] = Hash;
+			Changed.push_back({ Offs, Offs + Length });
+		}
+
+		if (Changed.empty()) return Res;
+		this->Generation++;
+
+		/* NDS: The physical Slots are the first 5 blocks, so the Slot directory might have changed. */
+		if (this->Sav->GetType() == SavType::_NDS && Changed.front().first < 0x5000) this->Sav->ValidationCheck();
+
+		/* Blocks can hold multiple Sections (NDS Paintings), so check the Sections inside changed blocks on their own. */
+		for (const SavSectionRef &Ref : SavLayout::Sections(*this->Sav)) {
+			for (const std::pair<uint32_t, uint32_t> &Range : Changed) {
+				if (Range.first >= Ref.Offs + Ref.Size || Ref.Offs >= Range.second) continue;
+
+				const uint64_t Hash = Checksum::Hash(this->Sav->GetData() + Ref.Offs, Ref.Size);
+				uint64_t &Known = this->SectionHashes[((uint16_t)Ref.Section << 8) | Ref.Index];
+
+				if (Known != Hash) {
+					Known = Hash;
+					Res.push_back(Ref);
+				}
+
+				break;
+			}
+		}
+
+		return Res;
+	};
+};
\ No newline at end of file
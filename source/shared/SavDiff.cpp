@@ -0,0 +1,171 @@
+/*
+*   This file is part of Sim2Editor-CPPCore
+*   Copyright (C) 2020-2021 Sim2Team
+*
+*   This program is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Additional Terms 7.b and 7.c of GPLv3 apply to this file:
+*       * Requiring preservation of specified reasonable legal notices or
+*         author attributions in that material or in the Appropriate Legal
+*         Notices displayed by works containing it.
+*       * Prohibiting misrepresentation of the origin of that material,
+*         or requiring that modified versions of such material be marked in
+*         reasonable ways as different from the original version.
+*/
+
+#include "Checksum.hpp"
+#include "DataHelper.hpp"
+#include "Sav.hpp"
+#include "SavDiff.hpp"
+
+
+namespace S2Core {
+	/*
+		Diff all Fields of a single Section.
+
+		const uint8_t *OldData: The old SavBuffer.
+		const SavSectionRef &OldRef: The Section inside the old SavBuffer.
+		const uint8_t *NewData: The new SavBuffer.
+		const SavSectionRef &NewRef: The Section inside the new SavBuffer.
+		const NDSSavRegion Region: The Region, for the character set of Strings.
+		std::vector<SavDiffEntry> &Res: Where to add the changed Fields to.
+	*/
+	static void DiffSection(const uint8_t *OldData, const SavSectionRef &OldRef, const uint8_t *NewData, const SavSectionRef &NewRef, const NDSSavRegion Region, std::vector<SavDiffEntry> &Res) {
+		const uint8_t OldItems = SavLayout::HouseItems(OldData, OldRef), NewItems = SavLayout::HouseItems(NewData, NewRef);
+
+		for (const SavRecord &Rec : SavLayout::Records(OldRef.Section)) {
+			const uint8_t OldCount = SavLayout::RecordCount(OldData, OldRef, Rec), NewCount = SavLayout::RecordCount(NewData, NewRef, Rec);
+
+			for (uint8_t Idx = 0; Idx < std::max(OldCount, NewCount); Idx++) {
+				for (const SavField &Field : Rec.Fields) {
+					SavDiffEntry Entry;
+
+					/* Records, which only exist on one side (GBA House Items) count as 0. */
+					if (Idx < OldCount) Entry.OldOffs = SavLayout::FieldOffs(OldRef, Rec, Field, Idx, OldItems);
+					if (Idx < NewCount) Entry.NewOffs = SavLayout::FieldOffs(NewRef, Rec, Field, Idx, NewItems);
+
+					switch(Field.Type) {
+						case SavFieldType::String:
+							if (Idx < OldCount) Entry.OldStr = DataHelper::ReadString(OldData, Entry.OldOffs, Field.Width, Region);
+							if (Idx < NewCount) Entry.NewStr = DataHelper::ReadString(NewData, Entry.NewOffs, Field.Width, Region);
+							if (Entry.OldStr == Entry.NewStr) continue;
+							break;
+
+						case SavFieldType::Raw:
+							for (uint16_t Byte = 0; Byte < Field.Width; Byte++) {
+								if (OldData[Entry.OldOffs + Byte] != NewData[Entry.NewOffs + Byte]) Entry.New++;
+							}
+
+							if (!Entry.New) continue;
+							break;
+
+						default:
+							if (Idx < OldCount) Entry.Old = SavLayout::Read(OldData, Entry.OldOffs, Field, Idx);
+							if (Idx < NewCount) Entry.New = SavLayout::Read(NewData, Entry.NewOffs, Field, Idx);
+							if (Entry.Old == Entry.New) continue;
+							break;
+					}
+
+					Entry.Path = SavLayout::Path(OldRef, Rec, Field, Idx);
+					Res.push_back(Entry);
+				}
+			}
+		}
+	};
+
+
+	/*
+		Return the content hashes of all Sections of a SAV, in the order of SavLayout::Sections().
+
+		const SAV &Sav: The SAV.
+	*/
+	std::vector<uint64_t> SavDiff::Hashes(const SAV &Sav) {
+		std::vector<uint64_t> Res;
+		if (!Sav.GetValid()) return Res;
+
+		for (const SavSectionRef &Ref : SavLayout::Sections(Sav)) Res.push_back(Checksum::Hash(Sav.GetData() + Ref.Offs, Ref.Size));
+		return Res;
+	};
+
+
+	/*
+		Diff two Savs of the same type.
+
+		const SAV &Old: The old SAV.
+		const SAV &New: The new SAV.
+	*/
+	std::vector<SavDiffEntry> SavDiff::Compare(const SAV &Old, const SAV &New) { return SavDiff::Compare(Old, { }, New); };
+
+
+	/*
+		Diff two Savs of the same type, using the already known Section hashes of the old SAV.
+
+		const SAV &Old: The old SAV.
+		const std::vector<uint64_t> &OldHashes: The Hashes() of the old SAV. If empty, the Sections are compared directly.
+		const SAV &New: The new SAV.
+
+		Returns the changed Fields, or nothing if the types don't match.
+	*/
+	std::vector<SavDiffEntry> SavDiff::Compare(const SAV &Old, const std::vector<uint64_t> &OldHashes, const SAV &New) {
+		std::vector<SavDiffEntry> Res;
+		if (!Old.GetValid() || !New.GetValid() || Old.GetType() != New.GetType()) return Res;
+
+		const std::vector<SavSectionRef> OldRefs = SavLayout::Sections(Old), NewRefs = SavLayout::Sections(New);
+		const bool UseHashes = (OldHashes.size() == OldRefs.size());
+
+		for (size_t Idx = 0; Idx < OldRefs.size(); Idx++) {
+			const SavSectionRef &OldRef = OldRefs[Idx];
+			const SavSectionRef *NewRef = nullptr;
+
+			for (const SavSectionRef &Ref : NewRefs) {
+				if (Ref.Section == OldRef.Section && Ref.Index == OldRef.Index) {
+					NewRef = &Ref;
+					break;
+				}
+			}
+
+			/* The Section got removed. */
+			if (!NewRef) {
+				Res.push_back({ SavLayout::SectionName(OldRef.Section) + std::to_string(OldRef.Index), OldRef.Offs, 0, 1, 0 });
+				continue;
+			}
+
+			/* Skip identical Sections. */
+			if (UseHashes) {
+				if (OldHashes[Idx] == Checksum::Hash(New.GetData() + NewRef->Offs, NewRef->Size)) continue;
+
+			} else if (!memcmp(Old.GetData() + OldRef.Offs, New.GetData() + NewRef->Offs, OldRef.Size)) {
+				continue;
+			}
+
+			DiffSection(Old.GetData(), OldRef, New.GetData(), *NewRef, Old.GetRegion(), Res);
+		}
+
+		/* Sections, which got added. */
+		for (const SavSectionRef &NewRef : NewRefs) {
+			bool Found = false;
+
+			for (const SavSectionRef &OldRef : OldRefs) {
+				if (OldRef.Section == NewRef.Section && OldRef.Index == NewRef.Index) {
+					Found = true;
+					break;
+				}
+			}
+
+			if (!Found) Res.push_back({ SavLayout::SectionName(NewRef.Section) + std::to_string(NewRef.Index), 0, NewRef.Offs, 0, 1 });
+		}
+
+		return Res;
+	};
+};
\ No newline at end of file
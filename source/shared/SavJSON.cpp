@@ -0,0 +1,212 @@
+/*
+*   This file is part of Sim2Editor-CPPCore
+*   Copyright (C) 2020-2021 Sim2Team
+*
+*   This program is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Additional Terms 7.b and 7.c of GPLv3 apply to this file:
+*       * Requiring preservation of specified reasonable legal notices or
+*         author attributions in that material or in the Appropriate Legal
+*         Notices displayed by works containing it.
+*       * Prohibiting misrepresentation of the origin of that material,
+*         or requiring that modified versions of such material be marked in
+*         reasonable ways as different from the original version.
+*/
+
+#include "Sav.hpp"
+#include "SavJSON.hpp"
+#include "StringCodec.hpp"
+#include "../Strings.hpp"
+
+
+namespace S2Core {
+	/*
+		Return the name table for a Record, or nullptr if it has none.
+
+		const SavRecord &Rec: The Record.
+		const bool DE: If the german names should be used.
+	*/
+	static const std::vector<std::string> *RecordNames(const SavRecord &Rec, const bool DE) {
+		if (!strcmp(Rec.Name, "Cast")) return (DE ? &Strings::GBACastNames_DE : &Strings::GBACastNames_EN);
+		if (!strcmp(Rec.Name, "Episode")) return (DE ? &Strings::GBAEpisodeNames_DE : &Strings::GBAEpisodeNames_EN);
+		if (!strcmp(Rec.Name, "SocialMove")) return (DE ? &Strings::GBASocialMoveNames_DE : &Strings::GBASocialMoveNames_EN);
+		if (!strcmp(Rec.Name, "Minigame")) return (DE ? &Strings::GBAMinigameNames_DE : &Strings::GBAMinigameNames_EN);
+
+		return nullptr;
+	};
+
+
+	/* Write a string from a table, if the index is in range. */
+	static void TableString(JSONWriter &Writer, const char *Key, const std::vector<std::string> &Table, const uint32_t Idx) {
+		if (Idx < Table.size()) Writer.String(Key, Table[Idx]);
+	};
+
+
+	/*
+		Write all Fields of a Record.
+
+		const uint8_t *Data: The SavBuffer.
+		const SavSectionRef &Ref: The Section.
+		const SavRecord &Rec: The Record.
+		const uint8_t Idx: The Record index.
+		const uint8_t HouseItems: The House Item count of the Section.
+		const bool DE: If the german names should be used.
+		const NDSSavRegion Region: The Region, for the character set of Strings.
+	*/
+	static void WriteFields(JSONWriter &Writer, const uint8_t *Data, const SavSectionRef &Ref, const SavRecord &Rec, const uint8_t Idx, const uint8_t HouseItems, const bool DE, const NDSSavRegion Region) {
+		for (const SavField &Field : Rec.Fields) {
+			const uint32_t Offs = SavLayout::FieldOffs(Ref, Rec, Field, Idx, HouseItems);
+
+			switch(Field.Type) {
+				case SavFieldType::String: {
+					char Str[StringCodec::MaxUTF8(0xFF)]; // Strings are at most 0xFF bytes, see SavPatch.
+					const size_t Length = StringCodec::Decode(Data + Offs, std::min<uint32_t>(0xFF, Field.Width), Str, sizeof(Str), Region);
+
+					Writer.String(Field.Name, Str, Length);
+					break;
+				}
+
+				case SavFieldType::Raw:
+					Writer.Hex(Field.Name, Data + Offs, Field.Width);
+					break;
+
+				default: {
+					const uint32_t V = SavLayout::Read(Data, Offs, Field, Idx);
+					Writer.Number(Field.Name, V);
+
+					/* Resolve some names. */
+					if (!strcmp(Field.Name, "ID") && (Ref.Section == SavSection::GBASlot)) {
+						TableString(Writer, "ItemName", Strings::GBAItemNames_EN, V);
+
+					} else if (!strcmp(Field.Name, "CurrentEpisode")) {
+						uint8_t Episode = 0;
+						while (Episode < Field.ValueCount && Field.Values[Episode] != V) Episode++;
+
+						TableString(Writer, "CurrentEpisodeName", (DE ? Strings::GBAEpisodeNames_DE : Strings::GBAEpisodeNames_EN), Episode);
+
+					} else if (!strcmp(Field.Name, "Flag") && (Ref.Section == SavSection::NDSPainting)) { // Same as NDSPainting::RankName().
+						const uint8_t Rank = ((V >= 0x29 || V % 2 == 0) ? 0 : std::min<uint8_t>(5, 1 + (V / 8)));
+						TableString(Writer, "RankName", Strings::NDSPaintingRankNames_EN, Rank);
+					}
+					break;
+				}
+			}
+		}
+	};
+
+
+	/*
+		Write a whole Section.
+
+		const uint8_t *Data: The SavBuffer.
+		const SavSectionRef &Ref: The Section.
+		const bool DE: If the german names should be used.
+		const NDSSavRegion Region: The Region, for the character set of Strings.
+		const char *Key: The key of the Section object, or nullptr inside of Arrays.
+	*/
+	static void WriteSection(JSONWriter &Writer, const uint8_t *Data, const SavSectionRef &Ref, const bool DE, const NDSSavRegion Region, const char *Key = nullptr) {
+		const uint8_t HouseItems = SavLayout::HouseItems(Data, Ref);
+
+		Writer.BeginObject(Key);
+		if (Ref.Section != SavSection::GBASettings) Writer.Number(SavLayout::SectionName(Ref.Section), Ref.Index);
+
+		for (const SavRecord &Rec : SavLayout::Records(Ref.Section)) {
+			if (Rec.Name[0] == '\0') {
+				WriteFields(Writer, Data, Ref, Rec, 0, HouseItems, DE, Region);
+				continue;
+			}
+
+			const std::vector<std::string> *Names = RecordNames(Rec, DE);
+			const uint8_t Count = SavLayout::RecordCount(Data, Ref, Rec);
+
+			Writer.BeginArray(Rec.Name);
+			for (uint8_t Idx = 0; Idx < Count; Idx++) {
+				Writer.BeginObject();
+				Writer.Number("Index", Idx);
+				if (Names) TableString(Writer, "Name", *Names, Idx);
+
+				WriteFields(Writer, Data, Ref, Rec, Idx, HouseItems, DE, Region);
+				Writer.EndObject();
+			}
+			Writer.EndArray();
+		}
+
+		Writer.EndObject();
+	};
+
+
+	/*
+		Export a SAV as JSON to a JSONWriter.
+
+		const SAV &Sav: The SAV to export.
+		JSONWriter &Writer: The Writer.
+
+		Returns false, if the SAV is invalid or the Writer failed.
+	*/
+	bool SavJSON::Export(const SAV &Sav, JSONWriter &Writer, const uint8_t Slots, const bool Paintings, const GBALanguage Lang) {
+		if (!Sav.GetValid()) return false;
+
+		const bool DE = (Lang == GBALanguage::DE);
+		const uint8_t *Data = Sav.GetData();
+		const std::vector<SavSectionRef> Refs = SavLayout::Sections(Sav);
+
+		Writer.BeginObject();
+		Writer.String("Type", (Sav.GetType() == SavType::_GBA ? "GBA" : "NDS"));
+		if (Sav.GetType() == SavType::_NDS) Writer.String("Region", (Sav.GetRegion() == NDSSavRegion::Jpn ? "Jpn" : "Int"));
+
+		/* Settings first. */
+		for (const SavSectionRef &Ref : Refs) {
+			if (Ref.Section != SavSection::GBASettings) continue;
+
+			WriteSection(Writer, Data, Ref, DE, Sav.GetRegion(), "Settings");
+		}
+
+		/* Then the Slots. */
+		Writer.BeginArray("Slots");
+		for (const SavSectionRef &Ref : Refs) {
+			if (Ref.Section != SavSection::GBASlot && Ref.Section != SavSection::NDSSlot) continue;
+			if (!(Slots & (1 << Ref.Index)) || !SavLayout::Used(Data, Ref)) continue;
+
+			WriteSection(Writer, Data, Ref, DE, Sav.GetRegion());
+		}
+		Writer.EndArray();
+
+		/* And at last the Paintings. */
+		if (Paintings && Sav.GetType() == SavType::_NDS) {
+			Writer.BeginArray("Paintings");
+			for (const SavSectionRef &Ref : Refs) {
+				if (Ref.Section != SavSection::NDSPainting || !SavLayout::Used(Data, Ref)) continue;
+
+				WriteSection(Writer, Data, Ref, DE, Sav.GetRegion());
+			}
+			Writer.EndArray();
+		}
+
+		Writer.EndObject();
+		return Writer.Flush();
+	};
+
+
+	/* Export a SAV as JSON, appended to a string. */
+	bool SavJSON::Export(const SAV &Sav, std::string &Out, const uint8_t Slots, const bool Paintings, const GBALanguage Lang) {
+		JSONWriter Writer(JSONWriter::StringSink(Out));
+		return SavJSON::Export(Sav, Writer, Slots, Paintings, Lang);
+	};
+
+	/* Export a SAV as JSON to a file descriptor. */
+	bool SavJSON::Export(const SAV &Sav, const int FD, const uint8_t Slots, const bool Paintings, const GBALanguage Lang) {
+		JSONWriter Writer(JSONWriter::FDSink(FD));
+		return SavJSON::Export(Sav, Writer, Slots, Paintings, Lang);
+	};
+};
\ No newline at end of file
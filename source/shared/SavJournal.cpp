@@ -0,0 +1,385 @@
+/*
+*   This file is part of Sim2Editor-CPPCore
+*   Copyright (C) 2020-2021 Sim2Team
+*
+*   This program is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Additional Terms 7.b and 7.c of GPLv3 apply to this file:
+*       * Requiring preservation of specified reasonable legal notices or
+*         author attributions in that material or in the Appropriate Legal
+*         Notices displayed by works containing it.
+*       * Prohibiting misrepresentation of the origin of that material,
+*         or requiring that modified versions of such material be marked in
+*         reasonable ways as different from the original version.
+*/
+
+#include "Checksum.hpp"
+#include "DataHelper.hpp"
+#include "Sav.hpp"
+#include "SavJournal.hpp"
+#include "SavLayout.hpp"
+#include <fcntl.h>
+#include <unistd.h>
+#include <vector>
+
+
+namespace S2Core {
+	/* Sync the data of a file, fdatasync is not available everywhere. */
+	static bool SyncFile(const int FD) {
+		#ifdef __linux__
+			return fdatasync(FD) == 0;
+		#else
+			return fsync(FD) == 0;
+		#endif
+	};
+
+
+	/* Write a whole buffer, retrying on short writes. */
+	static bool WriteAll(const int FD, const uint8_t *Data, size_t Length) {
+		while (Length > 0) {
+			const ssize_t Written = write(FD, Data, Length);
+			if (Written <= 0) return false;
+
+			Data += Written;
+			Length -= Written;
+		}
+
+		return true;
+	};
+
+
+	/*
+		Initialize the journal of a SAV. Nothing is touched on disk until Open().
+
+		SAV &Sav: The SAV, which needs to be loaded from a file.
+	*/
+	SavJournal::SavJournal(SAV &Sav) : Sav(Sav) {
+		if (this->Sav.GetValid() && this->Sav.GetPath() != "") this->Path = this->Sav.GetPath() + ".s2j";
+	};
+
+
+	SavJournal::~SavJournal() {
+		if (this->Compactor.joinable()) this->Compactor.join(); // Not Wait(), the SAV may be gone already.
+		if (this->FD != -1) close(this->FD);
+	};
+
+
+	/*
+		Walk the transactions of a journal.
+
+		const uint8_t *Data: The journal, without its header.
+		const uint32_t Length: The size of the journal, without its header.
+		uint8_t *Out: If not nullptr, the transactions get applied to that buffer and marked dirty in the SAV.
+		int SavFD: If not -1, the transactions get written to that file.
+
+		Returns the size of all complete transactions. Anything past that is a torn append.
+	*/
+	uint32_t SavJournal::Replay(const uint8_t *Data, const uint32_t Length, uint8_t *Out, int SavFD) {
+		uint32_t Pos = 0;
+
+		while (Pos + 0xC <= Length) {
+			const uint32_t PayloadSize = DataHelper::Read<uint32_t>(Data, Pos);
+			if (PayloadSize > Length - Pos - 0xC) break;
+
+			const uint8_t *Payload = Data + Pos + 0xC;
+			if (Checksum::Hash(Payload, PayloadSize) != DataHelper::Read<uint64_t>(Data, Pos + 0x4)) break;
+
+			/* Check all entries first, so a transaction applies completely or not at all. */
+			bool Good = true;
+			for (uint32_t Entry = 0; Good && Entry < PayloadSize;) {
+				if (Entry + 0x8 > PayloadSize) {
+					Good = false;
+					break;
+				}
+
+				const uint32_t Offs = DataHelper::Read<uint32_t>(Payload, Entry), EntryLength = DataHelper::Read<uint32_t>(Payload, Entry + 0x4);
+				Good = (EntryLength <= PayloadSize - Entry - 0x8 && Offs <= this->Sav.GetSize() && EntryLength <= this->Sav.GetSize() - Offs);
+				Entry += 0x8 + EntryLength;
+			}
+
+			if (!Good) break;
+
+			for (uint32_t Entry = 0; Entry < PayloadSize;) {
+				const uint32_t Offs = DataHelper::Read<uint32_t>(Payload, Entry), EntryLength = DataHelper::Read<uint32_t>(Payload, Entry + 0x4);
+
+				if (Out) {
+					memcpy(Out + Offs, Payload + Entry + 0x8, EntryLength);
+					this->Sav.MarkDirty(Offs, EntryLength);
+				}
+
+				if (SavFD != -1 && pwrite(SavFD, Payload + Entry + 0x8, EntryLength, Offs) != (ssize_t)EntryLength) return 0;
+				Entry += 0x8 + EntryLength;
+			}
+
+			Pos += 0xC + PayloadSize;
+		}
+
+		return Pos;
+	};
+
+
+	/*
+		Empty the journal and write a new header.
+
+		const uint64_t Base: The hash of the SavFile, which the journal builds on from now on.
+	*/
+	bool SavJournal::Reset(const uint64_t Base) {
+		uint8_t Header[this->HeaderSize] = { 0x0 };
+		memcpy(Header, this->Magic, 4);
+		Header[0x4] = this->Version;
+		DataHelper::Write<uint32_t>(Header, 0x8, this->Sav.GetSize());
+		DataHelper::Write<uint64_t>(Header, 0xC, Base);
+
+		if (ftruncate(this->FD, 0) != 0 || pwrite(this->FD, Header, this->HeaderSize, 0) != this->HeaderSize || !SyncFile(this->FD)) return false;
+
+		this->Size = this->HeaderSize;
+		stat(this->Sav.GetPath().c_str(), &this->Stamp);
+		return true;
+	};
+
+
+	/* Read the Sav data of the SavFile. */
+	bool SavJournal::ReadSav(std::vector<uint8_t> &Out) const {
+		const int SavFD = open(this->Sav.GetPath().c_str(), O_RDONLY);
+		if (SavFD == -1) return false;
+
+		Out.resize(this->Sav.GetSize());
+		const bool Good = (pread(SavFD, Out.data(), Out.size(), 0) == (ssize_t)Out.size());
+		close(SavFD);
+		return Good;
+	};
+
+
+	/* Return, if the SavFile got written by someone else since the journal last wrote or looked at it. */
+	bool SavJournal::Stale() const {
+		struct stat Info;
+		if (stat(this->Sav.GetPath().c_str(), &Info) != 0) return true;
+
+		#ifdef __APPLE__
+			const bool SameTime = (Info.st_mtimespec.tv_sec == this->Stamp.st_mtimespec.tv_sec && Info.st_mtimespec.tv_nsec == this->Stamp.st_mtimespec.tv_nsec);
+		#else
+			const bool SameTime = (Info.st_mtim.tv_sec == this->Stamp.st_mtim.tv_sec && Info.st_mtim.tv_nsec == this->Stamp.st_mtim.tv_nsec);
+		#endif
+
+		return !SameTime || Info.st_size != this->Stamp.st_size || Info.st_ino != this->Stamp.st_ino || Info.st_dev != this->Stamp.st_dev;
+	};
+
+
+	/* After a Compact(), clear the dirty granules, which the SavFile holds now. Call from the thread editing the SAV, with the Mutex held. */
+	void SavJournal::Settle() {
+		if (this->OnDisk.size() != this->Sav.GetSize()) return;
+
+		for (const std::pair<uint32_t, uint32_t> &Range : this->Sav.DirtyRanges()) {
+			for (uint32_t Offs = Range.first; Offs < Range.first + Range.second; Offs += SAV::DirtyGranule) {
+				const uint32_t Length = std::min(SAV::DirtyGranule, this->Sav.GetSize() - Offs);
+				if (!memcmp(this->Sav.GetData() + Offs, this->OnDisk.data() + Offs, Length)) this->Sav.ClearDirty(Offs, Length);
+			}
+		}
+
+		this->OnDisk.clear();
+	};
+
+
+	/*
+		Open the journal and replay it, if there is one left from before.
+
+		Returns the amount of replayed bytes. If anything got replayed, the SAV counts as changed and the replayed bytes as dirty,
+		as they are safe inside the journal, but not inside the SavFile yet.
+	*/
+	uint32_t SavJournal::Open() {
+		std::lock_guard<std::mutex> Lock(this->Mutex);
+		if (this->Path == "" || this->FD != -1) return 0;
+
+		this->FD = open(this->Path.c_str(), O_RDWR | O_CREAT, 0666);
+		if (this->FD == -1) return 0;
+
+		const off_t Length = lseek(this->FD, 0, SEEK_END);
+		std::vector<uint8_t> Journal(Length > 0 ? Length : 0);
+		if (Length > 0 && pread(this->FD, Journal.data(), Length, 0) != Length) Journal.clear();
+
+		/* A missing, damaged, foreign or out of date journal gets started over. */
+		const uint64_t Base = Checksum::Hash(this->Sav.GetData(), this->Sav.GetSize());
+
+		if (Journal.size() < this->HeaderSize || memcmp(Journal.data(), this->Magic, 4) || Journal[0x4] != this->Version
+			|| DataHelper::Read<uint32_t>(Journal.data(), 0x8) != this->Sav.GetSize() || DataHelper::Read<uint64_t>(Journal.data(), 0xC) != Base) {
+			if (!this->Reset(Base)) {
+				close(this->FD);
+				this->FD = -1;
+			}
+
+			this->Shadow.assign(this->Sav.GetData(), this->Sav.GetData() + this->Sav.GetSize());
+			return 0;
+		}
+
+		const uint32_t Replayed = this->Replay(Journal.data() + this->HeaderSize, Journal.size() - this->HeaderSize, this->Sav.GetData(), -1);
+		this->Size = this->HeaderSize + Replayed;
+
+		/* Drop a torn append at the end, so new transactions follow the last good one. */
+		if (this->Size != Journal.size() && ftruncate(this->FD, this->Size) != 0) {
+			close(this->FD);
+			this->FD = -1;
+			return 0;
+		}
+
+		if (Replayed) {
+			this->Sav.SetChangesMade(true);
+			this->Sav.Publish();
+		}
+
+		stat(this->Sav.GetPath().c_str(), &this->Stamp);
+		this->Shadow.assign(this->Sav.GetData(), this->Sav.GetData() + this->Sav.GetSize());
+		return Replayed;
+	};
+
+
+	/*
+		Commit the dirty bytes of the SAV, which changed since the last Commit(), to the journal.
+
+		Returns false, if the journal isn't open or writing failed.
+		The committed bytes stay dirty either way, until Compact() wrote them into the SavFile.
+	*/
+	bool SavJournal::Commit() {
+		std::lock_guard<std::mutex> Lock(this->Mutex);
+		if (this->FD == -1) return false;
+
+		this->Settle();
+		SavLayout::FixDirtyChecksums(this->Sav); // Same as SAV::Finish() would do.
+
+		/* The SavFile got written some other way, so the journal builds on the new SavFile from now on. */
+		if (this->Stale()) {
+			std::vector<uint8_t> Current;
+			if (!this->ReadSav(Current) || !this->Reset(Checksum::Hash(Current.data(), Current.size()))) return false;
+
+			this->Shadow = std::move(Current);
+		}
+
+		/* Only the granules, which differ from the SavFile with the journal applied. */
+		std::vector<std::pair<uint32_t, uint32_t>> Ranges;
+		for (const std::pair<uint32_t, uint32_t> &Range : this->Sav.DirtyRanges()) {
+			for (uint32_t Offs = Range.first; Offs < Range.first + Range.second; Offs += SAV::DirtyGranule) {
+				const uint32_t Length = std::min(SAV::DirtyGranule, this->Sav.GetSize() - Offs);
+				if (!memcmp(this->Sav.GetData() + Offs, this->Shadow.data() + Offs, Length)) continue;
+
+				if (!Ranges.empty() && Ranges.back().first + Ranges.back().second == Offs) Ranges.back().second += Length;
+				else Ranges.push_back({ Offs, Length });
+			}
+		}
+
+		if (Ranges.empty()) {
+			this->Sav.SetChangesMade(false);
+			return true;
+		}
+
+		std::vector<uint8_t> Transaction(0xC);
+		for (const std::pair<uint32_t, uint32_t> &Range : Ranges) {
+			const size_t Pos = Transaction.size();
+			Transaction.resize(Pos + 0x8);
+			DataHelper::Write<uint32_t>(Transaction.data(), Pos, Range.first);
+			DataHelper::Write<uint32_t>(Transaction.data(), Pos + 0x4, Range.second);
+			Transaction.insert(Transaction.end(), this->Sav.GetData() + Range.first, this->Sav.GetData() + Range.first + Range.second);
+		}
+
+		DataHelper::Write<uint32_t>(Transaction.data(), 0x0, Transaction.size() - 0xC);
+		DataHelper::Write<uint64_t>(Transaction.data(), 0x4, Checksum::Hash(Transaction.data() + 0xC, Transaction.size() - 0xC));
+
+		if (lseek(this->FD, this->Size, SEEK_SET) != this->Size || !WriteAll(this->FD, Transaction.data(), Transaction.size()) || !SyncFile(this->FD)) {
+			/* Cut off whatever made it, so the next Commit() does not append behind garbage. If even that fails, give up on the journal. */
+			if (ftruncate(this->FD, this->Size) != 0) {
+				close(this->FD);
+				this->FD = -1;
+			}
+
+			return false;
+		}
+
+		this->Size += Transaction.size();
+		for (const std::pair<uint32_t, uint32_t> &Range : Ranges) memcpy(this->Shadow.data() + Range.first, this->Sav.GetData() + Range.first, Range.second);
+		this->Sav.SetChangesMade(false);
+		return true;
+	};
+
+
+	/* Write the journal into the SavFile and empty it. */
+	bool SavJournal::DoCompact() {
+		std::lock_guard<std::mutex> Lock(this->Mutex);
+		if (this->FD == -1) return false;
+		if (this->Size == this->HeaderSize) return true;
+
+		/* The SavFile got written some other way, with everything the journal has, so there is nothing to write. */
+		if (this->Stale()) {
+			std::vector<uint8_t> Current;
+			if (!this->ReadSav(Current) || !this->Reset(Checksum::Hash(Current.data(), Current.size()))) return false;
+
+			this->Shadow = Current;
+			this->OnDisk = std::move(Current);
+			return true;
+		}
+
+		std::vector<uint8_t> Journal(this->Size - this->HeaderSize);
+		if (pread(this->FD, Journal.data(), Journal.size(), this->HeaderSize) != (ssize_t)Journal.size()) return false;
+
+		const int SavFD = open(this->Sav.GetPath().c_str(), O_RDWR);
+		if (SavFD == -1) return false;
+
+		/* The new base is what is in the SavFile afterwards, which may be older than the SAV, if it has uncommitted edits. */
+		std::vector<uint8_t> Written(this->Sav.GetSize());
+		const bool Good = (this->Replay(Journal.data(), Journal.size(), nullptr, SavFD) == Journal.size() && SyncFile(SavFD)
+			&& pread(SavFD, Written.data(), Written.size(), 0) == (ssize_t)Written.size());
+		close(SavFD);
+
+		/* Only empty the journal once the SavFile is safe. */
+		if (!Good || !this->Reset(Checksum::Hash(Written.data(), Written.size()))) return false;
+
+		this->OnDisk = std::move(Written);
+		return true;
+	};
+
+
+	/*
+		Write the journal into the SavFile and empty it.
+
+		const bool Async: If that should happen on a background thread. Use Wait() to wait for it.
+
+		Returns false, if the journal isn't open or compacting failed. Async always returns true, if the journal is open.
+	*/
+	bool SavJournal::Compact(const bool Async) {
+		this->Wait();
+		if (this->FD == -1) return false;
+
+		if (Async) {
+			this->Compactor = std::thread([this]() { this->DoCompact(); });
+			return true;
+		}
+
+		const bool Res = this->DoCompact();
+		this->Wait();
+		return Res;
+	};
+
+
+	/* Wait for a running Compact(), and clear the dirty granules it wrote into the SavFile. */
+	void SavJournal::Wait() {
+		if (this->Compactor.joinable()) this->Compactor.join();
+
+		std::lock_guard<std::mutex> Lock(this->Mutex);
+		this->Settle();
+	};
+
+
+	/* Return the current size of the journal file. */
+	uint32_t SavJournal::GetSize() {
+		std::lock_guard<std::mutex> Lock(this->Mutex);
+		return this->Size;
+	};
+};
\ No newline at end of file
@@ -0,0 +1,661 @@
+/*
+*   This file is part of Sim2Editor-CPPCore
+*   Copyright (C) 2020-2021 Sim2Team
+*
+*   This program is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Additional Terms 7.b and 7.c of GPLv3 apply to this file:
+*       * Requiring preservation of specified reasonable legal notices or
+*         author attributions in that material or in the Appropriate Legal
+*         Notices displayed by works containing it.
+*       * Prohibiting misrepresentation of the origin of that material,
+*         or requiring that modified versions of such material be marked in
+*         reasonable ways as different from the original version.
+*/
+
+#include "Checksum.hpp"
+#include "DataHelper.hpp"
+#include "Sav.hpp"
+#include "SavLayout.hpp"
+
+
+namespace S2Core {
+	/* Legal Value sets, same as the ones of the GBASlot and GBASettings classes. */
+	static constexpr uint8_t GBAEpisodeVals[12] = { 0x0, 0x1, 0x3, 0x7, 0x6, 0xA, 0x8, 0xF, 0xD, 0x5, 0x16, 0x15 };
+	static constexpr uint8_t GBAMusicLevels[11] = { 0x0, 0x19, 0x32, 0x4B, 0x64, 0x7D, 0x96, 0xAF, 0xC8, 0xE1, 0xFF };
+	static constexpr uint8_t GBASFXLevels[11]   = { 0x0, 0x0C, 0x18, 0x24, 0x30, 0x3C, 0x48, 0x54, 0x60, 0x6C, 0x80 };
+	static constexpr uint8_t GBADirections[4]   = { 0x1, 0x3, 0x5, 0x7 };
+
+	/* The Episode offsets, same as the ones of the GBAEpisode class. */
+	static constexpr uint32_t GBAEpisodeOffs[11] = { 0x104, 0x10E, 0x122, 0x11D, 0x131, 0x127, 0x14A, 0x140, 0x118, 0x16D, 0x168 };
+
+
+	/* The 3 Item fields, which are the same for all GBAItem groups. */
+	static const std::vector<SavField> GBAItemFields = {
+		{ "ID", 0x0, SavFieldType::U8, 0, 0, 0x0, 0xFF },
+		{ "Flag", 0x1, SavFieldType::U8, 0, 0, 0x0, 0xFF },
+		{ "UseCount", 0x2, SavFieldType::U8, 0, 0, 0x0, 0xFF }
+	};
+
+	/*
+		Return the Records of a Section.
+
+		const SavSection Section: The Section.
+	*/
+	const std::vector<SavRecord> &SavLayout::Records(const SavSection Section) {
+		static const std::vector<SavRecord> GBASettings = {
+			{ "", 0x0, 0x0, 1, false, {
+				{ "SFX", 0x8, SavFieldType::U8, 0, 0, 0x0, 0x80, false, GBASFXLevels, 11, 0x0, true },
+				{ "Music", 0x9, SavFieldType::U8, 0, 0, 0x0, 0xFF, false, GBAMusicLevels, 11, 0x0, true },
+				{ "Language", 0xA, SavFieldType::U8, 0, 0, 0x0, 0x5 },
+				{ "Checksum", 0xE, SavFieldType::U16, 0, 0, 0x0, 0xFFFF, true }
+			} }
+		};
+
+		static const std::vector<SavRecord> GBASlot = {
+			{ "", 0x0, 0x0, 1, false, {
+				{ "Hour", 0x2, SavFieldType::U8, 0, 0, 0, 23 },
+				{ "Minute", 0x3, SavFieldType::U8, 0, 0, 0, 59 },
+				{ "Simoleons", 0x5, SavFieldType::U24, 0, 0, 0, 999999 },
+				{ "Ratings", 0xA, SavFieldType::U16, 0, 0, 0, 9999 },
+				{ "Name", 0xD, SavFieldType::String, 0, 0x8, 0, 0 },
+
+				/* Appearance. */
+				{ "Hairstyle", 0x1D, SavFieldType::Bits, 5, 3, 0, 7, false, nullptr, 0, 0x0, true },
+				{ "Shirtcolor3", 0x1D, SavFieldType::Bits, 0, 5, 0, 31, false, nullptr, 0, 0x0, true },
+				{ "Tan", 0x1E, SavFieldType::Bits, 5, 3, 0, 5, false, nullptr, 0, 0x0, true },
+				{ "Shirtcolor2", 0x1E, SavFieldType::Bits, 0, 5, 0, 31, false, nullptr, 0, 0x0, true },
+				{ "Haircolor", 0x1F, SavFieldType::Bits, 4, 4, 0, 15, false, nullptr, 0, 0x0, true },
+				{ "Hatcolor", 0x1F, SavFieldType::Bits, 0, 4, 0, 15, false, nullptr, 0, 0x0, true },
+				{ "Shirt", 0x20, SavFieldType::Bits, 5, 3, 0, 5, false, nullptr, 0, 0x0, true },
+				{ "Shirtcolor1", 0x20, SavFieldType::Bits, 0, 5, 0, 31, false, nullptr, 0, 0x0, true },
+				{ "Pants", 0x21, SavFieldType::Bits, 5, 3, 0, 1, false, nullptr, 0, 0x0, true },
+				{ "Pantscolor", 0x21, SavFieldType::Bits, 0, 5, 0, 31, false, nullptr, 0, 0x0, true },
+
+				/* Skill Points. */
+				{ "Confidence", 0x22, SavFieldType::U8, 0, 0, 0, 5 },
+				{ "Mechanical", 0x23, SavFieldType::U8, 0, 0, 0, 5 },
+				{ "Strength", 0x24, SavFieldType::U8, 0, 0, 0, 5 },
+				{ "Personality", 0x25, SavFieldType::U8, 0, 0, 0, 5 },
+				{ "Hotness", 0x26, SavFieldType::U8, 0, 0, 0, 5 },
+				{ "Intellect", 0x27, SavFieldType::U8, 0, 0, 0, 5 },
+				{ "Roomdesign", 0x2E, SavFieldType::Bits, 0, 4, 0, 3 },
+				{ "Sanity", 0x32, SavFieldType::U8, 0, 0, 0, 100 },
+				{ "Aspiration", 0x4B, SavFieldType::U8, 0, 0, 0, 2 },
+
+				/* Item Counts, which are kept in sync by GBAItem::ID() and GBAHouseItem::AddItem() / RemoveItem(). */
+				{ "PawnShopCount", 0x4C, SavFieldType::U8, 0, 0, 0, 6, true },
+				{ "SaloonCount", 0x5F, SavFieldType::U8, 0, 0, 0, 6, true },
+				{ "SkillsCount", 0x72, SavFieldType::U8, 0, 0, 0, 6, true },
+				{ "MailboxCount", 0x98, SavFieldType::U8, 0, 0, 0, 6, true },
+				{ "InventoryCount", 0xAB, SavFieldType::U8, 0, 0, 0, 6, true },
+				{ "HouseItemCount", 0xD6, SavFieldType::U8, 0, 0, 0, 12, true },
+
+				{ "Checksum", 0xFFE, SavFieldType::U16, 0, 0, 0x0, 0xFFFF, true }
+			} },
+
+			/* The plain fields behind the House Items. */
+			{ "", 0x0, 0x0, 1, true, {
+				{ "Cans", 0xF6, SavFieldType::U8, 0, 0, 0, 250 },
+				{ "Cowbells", 0xF7, SavFieldType::U8, 0, 0, 0, 250 },
+				{ "Spaceship", 0xF8, SavFieldType::U8, 0, 0, 0, 250 },
+				{ "Fuelrods", 0xF9, SavFieldType::U8, 0, 0, 0, 250 },
+				{ "CansPrice", 0xFA, SavFieldType::U8, 0, 0, 0, 0xFF },
+				{ "CowbellsPrice", 0xFB, SavFieldType::U8, 0, 0, 0, 0xFF },
+				{ "SpaceshipPrice", 0xFC, SavFieldType::U8, 0, 0, 0, 0xFF },
+				{ "FuelrodsPrice", 0xFD, SavFieldType::U8, 0, 0, 0, 0xFF },
+				{ "CurrentEpisode", 0x1A3, SavFieldType::U8, 0, 0, 0x0, 0x16, false, GBAEpisodeVals, 12, 0x9, true },
+				{ "MysteryPlot", 0x1CF, SavFieldType::Bits, 0, 1, 0, 1 },
+				{ "FriendlyPlot", 0x1CF, SavFieldType::Bits, 1, 1, 0, 1 },
+				{ "RomanticPlot", 0x1CF, SavFieldType::Bits, 2, 1, 0, 1 },
+				{ "IntimidatingPlot", 0x1CF, SavFieldType::Bits, 3, 1, 0, 1 },
+				{ "TheChopperPlot", 0x1CF, SavFieldType::Bits, 4, 1, 0, 1 },
+				{ "WeirdnessPlot", 0x1CF, SavFieldType::Bits, 5, 1, 0, 1 },
+				{ "TheChopperColor", 0x1F2, SavFieldType::Bits, 0, 4, 0, 9 }
+			} },
+
+			/* Item Groups. */
+			{ "PawnShop", 0x4D, 0x3, 6, false, GBAItemFields, nullptr, 0x0, 0x4C, 0xE6 },
+			{ "Saloon", 0x60, 0x3, 6, false, GBAItemFields, nullptr, 0x0, 0x5F, 0xE6 },
+			{ "Skills", 0x73, 0x3, 6, false, GBAItemFields, nullptr, 0x0, 0x72, 0xE6 },
+			{ "Mailbox", 0x99, 0x3, 6, false, GBAItemFields, nullptr, 0x0, 0x98, 0xE6 },
+			{ "Inventory", 0xAC, 0x3, 6, false, GBAItemFields, nullptr, 0x0, 0xAB, 0xE6 },
+
+			{ "HouseItem", 0xD7, 0x6, 12, false, {
+				{ "ID", 0x0, SavFieldType::U8, 0, 0, 0x0, 0xFF },
+				{ "Flag", 0x1, SavFieldType::U8, 0, 0, 0x0, 0xFF },
+				{ "UseCount", 0x2, SavFieldType::U8, 0, 0, 0x0, 0xFF },
+				{ "XPos", 0x3, SavFieldType::U8, 0, 0, 0x0, 0xFF },
+				{ "YPos", 0x4, SavFieldType::U8, 0, 0, 0x0, 0xFF },
+				{ "Direction", 0x5, SavFieldType::U8, 0, 0, 0x1, 0x7, false, GBADirections, 4, 0x0, true }
+			}, nullptr, 0xD6 },
+
+			{ "Episode", 0x0, 0x0, 11, true, {
+				{ "Rating0", 0x0, SavFieldType::U8, 0, 0, 0, 25 },
+				{ "Rating1", 0x1, SavFieldType::U8, 0, 0, 0, 25 },
+				{ "Rating2", 0x2, SavFieldType::U8, 0, 0, 0, 25 },
+				{ "Rating3", 0x3, SavFieldType::U8, 0, 0, 0, 25 },
+				{ "State", 0x4, SavFieldType::U8, 0, 0, 0, 1 }
+			}, GBAEpisodeOffs },
+
+			{ "Minigame", 0x1AD, 0x1, 7, true, {
+				{ "Played", 0x0, SavFieldType::IndexBit, 0, 1, 0, 1 },
+				{ "Level", 0x24, SavFieldType::U8, 0, 0, 0, 5 }
+			} },
+
+			{ "SocialMove", 0x3EE, 0x8, 15, true, {
+				{ "Flag", 0x0, SavFieldType::U8, 0, 0, 0, 2 },
+				{ "Level", 0x4, SavFieldType::U8, 0, 0, 0, 3 },
+				{ "BlockedHours", 0x6, SavFieldType::U8, 0, 0, 0, 3 }
+			} },
+
+			{ "Cast", 0x466, 0xA, 26, true, {
+				{ "Friendly", 0x0, SavFieldType::U8, 0, 0, 0, 3 },
+				{ "Romance", 0x1, SavFieldType::U8, 0, 0, 0, 3 },
+				{ "Intimidate", 0x2, SavFieldType::U8, 0, 0, 0, 3 },
+				{ "Feeling", 0x3, SavFieldType::U8, 0, 0, 0, 3 },
+				{ "FeelingEffectHours", 0x6, SavFieldType::U8, 0, 0, 0, 0xFF },
+				{ "RegisteredOnPhone", 0x7, SavFieldType::U8, 0, 0, 0, 1 },
+				{ "Secret", 0x8, SavFieldType::U8, 0, 0, 0, 1 }
+			} }
+		};
+
+		static const std::vector<SavRecord> NDSSlot = {
+			{ "", 0x0, 0x0, 1, false, {
+				{ "SaveCount", 0x8, SavFieldType::U32, 0, 0, 0x0, 0xFFFFFFFF, true },
+				{ "Checksum", 0x28, SavFieldType::U16, 0, 0, 0x0, 0xFFFF, true },
+				{ "Simoleons", 0x2C, SavFieldType::U32, 0, 0, 0, 999999 },
+				{ "Name", 0x30, SavFieldType::String, 0, 0x7, 0, 0 },
+				{ "Fuelrods", 0xBC, SavFieldType::U8, 0, 0, 0, 250 },
+				{ "Plates", 0xBD, SavFieldType::U8, 0, 0, 0, 250 },
+				{ "Gourds", 0xBE, SavFieldType::U8, 0, 0, 0, 250 },
+				{ "Spaceship", 0xBF, SavFieldType::U8, 0, 0, 0, 250 },
+				{ "PocketCount", 0xCF, SavFieldType::U8, 0, 0, 0, 6, true },
+				{ "Creativity", 0xDF, SavFieldType::U8, 0, 0, 0, 10 },
+				{ "Business", 0xE0, SavFieldType::U8, 0, 0, 0, 10 },
+				{ "Body", 0xE1, SavFieldType::U8, 0, 0, 0, 10 },
+				{ "Charisma", 0xE2, SavFieldType::U8, 0, 0, 0, 10 },
+				{ "Mechanical", 0xE3, SavFieldType::U8, 0, 0, 0, 10 }
+			} },
+
+			{ "Pocket", 0xC3, 0x2, 6, false, {
+				{ "ID", 0x0, SavFieldType::U16, 0, 0, 0x0, 0xFFFF }
+			}, nullptr, 0x0, 0xCF, 0x0 }
+		};
+
+		static const std::vector<SavRecord> NDSPainting = {
+			{ "", 0x0, 0x0, 1, false, {
+				{ "Index", 0x8, SavFieldType::U32, 0, 0, 0x0, 0xFFFFFFFF },
+				{ "Slot", 0xC, SavFieldType::U8, 0, 0, 0, 5 },
+				{ "CanvasIdx", 0xD, SavFieldType::U8, 0, 0, 0, 5 },
+				{ "HeaderChecksum", 0xE, SavFieldType::U16, 0, 0, 0x0, 0xFFFF, true },
+				{ "Checksum", 0x10, SavFieldType::U16, 0, 0, 0x0, 0xFFFF, true },
+				{ "Pixels", 0x14, SavFieldType::Raw, 0, 0x300, 0, 0 },
+				{ "Flag", 0x314, SavFieldType::U8, 0, 0, 0x0, 0x28 },
+				{ "Palette", 0x315, SavFieldType::U8, 0, 0, 0x0, 0xF }
+			} }
+		};
+
+		switch(Section) {
+			case SavSection::GBASettings:
+				return GBASettings;
+
+			case SavSection::GBASlot:
+				return GBASlot;
+
+			case SavSection::NDSSlot:
+				return NDSSlot;
+
+			case SavSection::NDSPainting:
+				break;
+		}
+
+		return NDSPainting;
+	};
+
+
+	/*
+		Return the name of a Section, as used for field paths such as 'Slot1.Cast3.Friendly'.
+
+		const SavSection Section: The Section.
+	*/
+	const char *SavLayout::SectionName(const SavSection Section) {
+		switch(Section) {
+			case SavSection::GBASettings:
+				return "Settings";
+
+			case SavSection::GBASlot:
+			case SavSection::NDSSlot:
+				return "Slot";
+
+			case SavSection::NDSPainting:
+				break;
+		}
+
+		return "Painting";
+	};
+
+
+	/*
+		Return all Sections of a SAV.
+
+		const SAV &Sav: The SAV.
+
+		GBA: The Settings and all 4 Slots.
+		NDS: The 3 logical Slots (only existing ones) and all 20 Paintings.
+	*/
+	std::vector<SavSectionRef> SavLayout::Sections(const SAV &Sav) {
+		std::vector<SavSectionRef> Refs;
+		if (!Sav.GetValid()) return Refs;
+
+		switch(Sav.GetType()) {
+			case SavType::_GBA:
+				Refs.push_back({ SavSection::GBASettings, 0, 0x0, 0x1000 });
+				for (uint8_t Slot = 1; Slot < 5; Slot++) Refs.push_back({ SavSection::GBASlot, Slot, (uint32_t)(Slot * 0x1000), 0x1000 });
+				break;
+
+			case SavType::_NDS:
+				for (uint8_t Slot = 0; Slot < 3; Slot++) {
+					if (Sav.GetNDSSlot(Slot) != -1) Refs.push_back({ SavSection::NDSSlot, Slot, (uint32_t)(Sav.GetNDSSlot(Slot) * 0x1000), 0x1000 });
+				}
+
+				for (uint8_t Idx = 0; Idx < 20; Idx++) Refs.push_back({ SavSection::NDSPainting, Idx, (uint32_t)(0x5000 + (Idx * 0x400)), 0x400 });
+				break;
+
+			case SavType::_NONE:
+				break;
+		}
+
+		return Refs;
+	};
+
+
+	/*
+		Return, if a Section is actually in use.
+
+		const uint8_t *Buffer: The SavBuffer.
+		const SavSectionRef &Ref: The Section.
+
+		GBA Slots are in use if one of their first 10 bytes is set (same as SAV::SlotExist()),
+		NDS Paintings if their Identifier matches (same as NDSPainting::Valid()).
+	*/
+	bool SavLayout::Used(const uint8_t *Buffer, const SavSectionRef &Ref) {
+		static constexpr uint8_t PaintingIdent[0x5] = { 0x70, 0x74, 0x67, 0x0, 0xF };
+		if (!Buffer) return false;
+
+		switch(Ref.Section) {
+			case SavSection::GBASlot:
+				for (uint8_t Idx = 0; Idx < 10; Idx++) {
+					if (Buffer[Ref.Offs + Idx] != 0) return true;
+				}
+
+				return false;
+
+			case SavSection::NDSPainting:
+				return !memcmp(Buffer + Ref.Offs, PaintingIdent, sizeof(PaintingIdent));
+
+			case SavSection::GBASettings:
+			case SavSection::NDSSlot:
+				break;
+		}
+
+		return true;
+	};
+
+
+	/*
+		Return the GBA House Item count of a Section, which shifts all 'Shifted' Records by 0x6 bytes per Item.
+
+		const uint8_t *Buffer: The SavBuffer.
+		const SavSectionRef &Ref: The Section.
+	*/
+	uint8_t SavLayout::HouseItems(const uint8_t *Buffer, const SavSectionRef &Ref) {
+		if (!Buffer || Ref.Section != SavSection::GBASlot) return 0;
+
+		return Buffer[Ref.Offs + 0xD6];
+	};
+
+
+	/*
+		Return the actual amount of Records.
+
+		const uint8_t *Buffer: The SavBuffer.
+		const SavSectionRef &Ref: The Section.
+		const SavRecord &Rec: The Record.
+	*/
+	uint8_t SavLayout::RecordCount(const uint8_t *Buffer, const SavSectionRef &Ref, const SavRecord &Rec) {
+		if (!Rec.CountOffs || !Buffer) return Rec.Count;
+
+		return std::min<uint8_t>(Rec.Count, Buffer[Ref.Offs + Rec.CountOffs]);
+	};
+
+
+	/*
+		Return the absolute offset of a Field.
+
+		const SavSectionRef &Ref: The Section.
+		const SavRecord &Rec: The Record.
+		const SavField &Field: The Field.
+		const uint8_t Idx: The Record index.
+		const uint8_t HouseItems: The House Item count of the Section.
+	*/
+	uint32_t SavLayout::FieldOffs(const SavSectionRef &Ref, const SavRecord &Rec, const SavField &Field, const uint8_t Idx, const uint8_t HouseItems) {
+		uint32_t Offs = Ref.Offs + Field.Offs + (Rec.Shifted ? HouseItems * 0x6 : 0x0);
+
+		if (Rec.Table) Offs += Rec.Table[Idx];
+		else Offs += Rec.Offs + (Field.Type == SavFieldType::IndexBit ? 0x0 : Idx * Rec.Stride);
+
+		return Offs;
+	};
+
+
+	/*
+		Update the count of non empty Records, same as GBAItem::ID() and NDSSlot::PocketID() do.
+
+		uint8_t *Buffer: The SavBuffer.
+		const SavSectionRef &Ref: The Section.
+		const SavRecord &Rec: The Record.
+	*/
+	void SavLayout::Tally(uint8_t *Buffer, const SavSectionRef &Ref, const SavRecord &Rec) {
+		if (!Buffer || !Rec.TallyOffs || Rec.Fields.empty()) return;
+
+		uint8_t Amount = 0;
+		for (uint8_t Idx = 0; Idx < Rec.Count; Idx++) {
+			if (SavLayout::Read(Buffer, SavLayout::FieldOffs(Ref, Rec, Rec.Fields[0], Idx, 0), Rec.Fields[0]) != Rec.EmptyID) Amount++;
+		}
+
+		Buffer[Ref.Offs + Rec.TallyOffs] = Amount;
+	};
+
+
+	/*
+		Return the Checksums of a Section.
+
+		const SavSection Section: The Section.
+
+		NOTE: The NDS Painting main Checksum is part of the header Checksum, so it has to come first.
+	*/
+	const std::vector<SavChecksum> &SavLayout::Checksums(const SavSection Section) {
+		static const std::vector<SavChecksum> GBASettings = { { "Checksum", 0x0, 0x18, 0xE, { 0xE } } };
+		static const std::vector<SavChecksum> GBASlot = { { "Checksum", 0x0, 0xFFE, 0xFFE, { } } };
+		static const std::vector<SavChecksum> NDSSlot = { { "Checksum", 0x10, 0x1000, 0x28, { 0x12, 0x28 } } };
+		static const std::vector<SavChecksum> NDSPainting = {
+			{ "Checksum", 0x10, 0x400, 0x10, { 0x10 } },
+			{ "HeaderChecksum", 0x0, 0x13, 0xE, { 0xE } }
+		};
+
+		switch(Section) {
+			case SavSection::GBASettings:
+				return GBASettings;
+
+			case SavSection::GBASlot:
+				return GBASlot;
+
+			case SavSection::NDSSlot:
+				return NDSSlot;
+
+			case SavSection::NDSPainting:
+				break;
+		}
+
+		return NDSPainting;
+	};
+
+
+	/*
+		Calculate a Checksum of a Section.
+
+		const uint8_t *Buffer: The SavBuffer.
+		const SavSectionRef &Ref: The Section.
+		const SavChecksum &CHKS: The Checksum.
+	*/
+	uint16_t SavLayout::CalcChecksum(const uint8_t *Buffer, const SavSectionRef &Ref, const SavChecksum &CHKS) {
+		std::vector<uint32_t> Skips;
+		for (const uint32_t Skip : CHKS.Skips) Skips.push_back((Ref.Offs + Skip) / 2);
+
+		return Checksum::Calc(Buffer, (Ref.Offs + CHKS.Start) / 2, (Ref.Offs + CHKS.End) / 2, Skips);
+	};
+
+
+	/*
+		Fix all Checksums of a Section, if it's in use.
+
+		uint8_t *Buffer: The SavBuffer.
+		const SavSectionRef &Ref: The Section.
+
+		Returns true if something got fixed.
+	*/
+	bool SavLayout::FixChecksums(uint8_t *Buffer, const SavSectionRef &Ref) {
+		if (!Buffer || !SavLayout::Used(Buffer, Ref)) return false;
+		bool Res = false;
+
+		for (const SavChecksum &CHKS : SavLayout::Checksums(Ref.Section)) {
+			const uint16_t Calced = SavLayout::CalcChecksum(Buffer, Ref, CHKS);
+
+			if (DataHelper::Read<uint16_t>(Buffer, Ref.Offs + CHKS.Offs) != Calced) {
+				DataHelper::Write<uint16_t>(Buffer, Ref.Offs + CHKS.Offs, Calced);
+				Res = true;
+			}
+		}
+
+		return Res;
+	};
+
+
+	/*
+		Fix the Checksums of all Sections of a SAV, which have dirty bytes, and mark the changed Checksums as dirty.
+
+		SAV &Sav: The SAV.
+
+		Returns the amount of Sections, whose Checksums got fixed.
+	*/
+	uint32_t SavLayout::FixDirtyChecksums(SAV &Sav) {
+		uint32_t Res = 0;
+
+		for (const SavSectionRef &Ref : SavLayout::Sections(Sav)) {
+			if (!Sav.Dirty(Ref.Offs, Ref.Size) || !SavLayout::FixChecksums(Sav.GetData(), Ref)) continue;
+
+			for (const SavChecksum &CHKS : SavLayout::Checksums(Ref.Section)) Sav.MarkDirty(Ref.Offs + CHKS.Offs, 2);
+			Res++;
+		}
+
+		return Res;
+	};
+
+
+	/*
+		Return the path of a Field, such as 'Slot1.Cast3.Friendly', 'Slot2.Simoleons' or 'Settings.Language'.
+
+		const SavSectionRef &Ref: The Section.
+		const SavRecord &Rec: The Record.
+		const SavField &Field: The Field.
+		const uint8_t Idx: The Record index.
+	*/
+	std::string SavLayout::Path(const SavSectionRef &Ref, const SavRecord &Rec, const SavField &Field, const uint8_t Idx) {
+		std::string Res = SavLayout::SectionName(Ref.Section);
+		if (Ref.Section != SavSection::GBASettings) Res += std::to_string(Ref.Index);
+		Res += ".";
+
+		if (Rec.Name[0] != '\0') {
+			Res += Rec.Name;
+			if (Rec.Count > 1) Res += std::to_string(Idx);
+			Res += ".";
+		}
+
+		return Res + Field.Name;
+	};
+
+
+	/*
+		Read a numeric Field.
+
+		const uint8_t *Buffer: The SavBuffer.
+		const uint32_t Offs: The absolute offset of the Field.
+		const SavField &Field: The Field.
+		const uint8_t Idx: The Record index (Only needed for IndexBit Fields).
+	*/
+	uint32_t SavLayout::Read(const uint8_t *Buffer, const uint32_t Offs, const SavField &Field, const uint8_t Idx) {
+		if (!Buffer) return 0;
+
+		switch(Field.Type) {
+			case SavFieldType::U8:
+				return Buffer[Offs];
+
+			case SavFieldType::U16:
+				return DataHelper::Read<uint16_t>(Buffer, Offs);
+
+			case SavFieldType::U32:
+				return DataHelper::Read<uint32_t>(Buffer, Offs);
+
+			case SavFieldType::U24:
+				return DataHelper::Read<uint32_t>(Buffer, Offs) >> 8;
+
+			case SavFieldType::Bits:
+				return (Buffer[Offs] >> Field.Shift) & ((1 << Field.Width) - 1);
+
+			case SavFieldType::IndexBit:
+				return (Buffer[Offs] >> Idx) & 1;
+
+			case SavFieldType::String:
+			case SavFieldType::Raw:
+				break;
+		}
+
+		return 0;
+	};
+
+
+	/*
+		Write a numeric Field. This does not clamp, use Clamp() for that.
+
+		uint8_t *Buffer: The SavBuffer.
+		const uint32_t Offs: The absolute offset of the Field.
+		const SavField &Field: The Field.
+		const uint32_t V: The value to write.
+		const uint8_t Idx: The Record index (Only needed for IndexBit Fields).
+	*/
+	void SavLayout::Write(uint8_t *Buffer, const uint32_t Offs, const SavField &Field, const uint32_t V, const uint8_t Idx) {
+		if (!Buffer) return;
+
+		switch(Field.Type) {
+			case SavFieldType::U8:
+				Buffer[Offs] = (uint8_t)V;
+				break;
+
+			case SavFieldType::U16:
+				DataHelper::Write<uint16_t>(Buffer, Offs, V);
+				break;
+
+			case SavFieldType::U32:
+				DataHelper::Write<uint32_t>(Buffer, Offs, V);
+				break;
+
+			case SavFieldType::U24:
+				DataHelper::Write<uint32_t>(Buffer, Offs, V << 8);
+				break;
+
+			case SavFieldType::Bits: {
+				const uint8_t Mask = ((1 << Field.Width) - 1) << Field.Shift;
+				Buffer[Offs] = (Buffer[Offs] & ~Mask) | ((V << Field.Shift) & Mask);
+				break;
+			}
+
+			case SavFieldType::IndexBit:
+				DataHelper::WriteBit(Buffer, Offs, Idx, V != 0);
+				break;
+
+			case SavFieldType::String:
+			case SavFieldType::Raw:
+				break;
+		}
+	};
+
+
+	/*
+		Return, if a value is legal for a Field.
+
+		const SavField &Field: The Field.
+		const uint32_t V: The value.
+	*/
+	bool SavLayout::Legal(const SavField &Field, const uint32_t V) {
+		if (V < Field.Min || V > Field.Max) return false;
+		if (!Field.Values) return true;
+
+		for (uint8_t Idx = 0; Idx < Field.ValueCount; Idx++) {
+			if (Field.Values[Idx] == V) return true;
+		}
+
+		return false;
+	};
+
+
+	/*
+		Clamp a value to the legal range of a Field, the same way as the setters of the GBA* / NDS* classes do.
+
+		const SavField &Field: The Field.
+		const uint32_t V: The value.
+
+		For Fields with a set of legal Values, the closest lower legal value is used.
+		The setters of Strict Fields ignore illegal values instead, so check Legal() first for those.
+	*/
+	uint32_t SavLayout::Clamp(const SavField &Field, const uint32_t V) {
+		uint32_t Res = std::max<uint32_t>(Field.Min, std::min<uint32_t>(Field.Max, V));
+		if (!Field.Values || SavLayout::Legal(Field, Res)) return Res;
+
+		uint32_t Best = Field.Values[0];
+		for (uint8_t Idx = 0; Idx < Field.ValueCount; Idx++) {
+			if (Field.Values[Idx] <= Res && (Field.Values[Idx] > Best || Best > Res)) Best = Field.Values[Idx];
+		}
+
+		return Best;
+	};
+
+
+	/*
+		Return, if a Field is a numeric one (so it works with Read / Write).
+
+		const SavField &Field: The Field.
+	*/
+	bool SavLayout::Numeric(const SavField &Field) {
+		return Field.Type != SavFieldType::String && Field.Type != SavFieldType::Raw;
+	};
+
+
+	/*
+		Return how many bytes a Field spans.
+
+		const SavField &Field: The Field.
+	*/
+	uint32_t SavLayout::Size(const SavField &Field) {
+		switch(Field.Type) {
+			case SavFieldType::U16:
+				return 2;
+
+			case SavFieldType::U32:
+			case SavFieldType::U24:
+				return 4;
+
+			case SavFieldType::String:
+			case SavFieldType::Raw:
+				return Field.Width;
+
+			case SavFieldType::U8:
+			case SavFieldType::Bits:
+			case SavFieldType::IndexBit:
+				break;
+		}
+
+		return 1;
+	};
+};
\ No newline at end of file
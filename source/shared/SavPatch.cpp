@@ -0,0 +1,545 @@
+/*
+*   This file is part of Sim2Editor-CPPCore
+*   Copyright (C) 2020-2021 Sim2Team
+*
+*   This program is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Additional Terms 7.b and 7.c of GPLv3 apply to this file:
+*       * Requiring preservation of specified reasonable legal notices or
+*         author attributions in that material or in the Appropriate Legal
+*         Notices displayed by works containing it.
+*       * Prohibiting misrepresentation of the origin of that material,
+*         or requiring that modified versions of such material be marked in
+*         reasonable ways as different from the original version.
+*/
+
+#include "DataHelper.hpp"
+#include "Sav.hpp"
+#include "SavPatch.hpp"
+#include <algorithm>
+
+
+namespace S2Core {
+	/*
+		Split a path part like 'Cast3' into its name and index.
+
+		const std::string &Part: The path part.
+		std::string &Name: Where to store the name.
+		int &Index: Where to store the index, -1 if there is none.
+	*/
+	static void SplitIndex(const std::string &Part, std::string &Name, int &Index) {
+		size_t Pos = Part.size();
+		while (Pos > 0 && isdigit((uint8_t)Part[Pos - 1])) Pos--;
+
+		Name = Part.substr(0, Pos);
+		Index = ((Pos < Part.size() && Part.size() - Pos < 4) ? std::stoi(Part.substr(Pos)) : -1);
+	};
+
+
+	/*
+		Resolve a path to a Patch operation.
+
+		const std::string &Path: The path, such as 'Slot1.Cast3.Friendly'.
+		SavPatchOp &Op: Where to store the resolved operation.
+
+		Returns false, if the path does not exist or the Field is read only.
+	*/
+	bool SavPatch::Resolve(const std::string &Path, SavPatchOp &Op) const {
+		std::vector<std::string> Parts;
+
+		for (size_t Start = 0, End = 0; End != std::string::npos; Start = End + 1) {
+			End = Path.find('.', Start);
+			Parts.push_back(Path.substr(Start, End - Start));
+		}
+
+		if (Parts.size() < 2 || Parts.size() > 3) return false;
+
+		/* The Section. */
+		std::string Name;
+		int Index = 0;
+		SplitIndex(Parts[0], Name, Index);
+
+		if (this->Type == SavType::_GBA && Name == "Settings" && Index == -1) {
+			Op.Section = SavSection::GBASettings;
+			Index = 0;
+
+		} else if (this->Type == SavType::_GBA && Name == "Slot" && Index >= 1 && Index <= 4) {
+			Op.Section = SavSection::GBASlot;
+
+		} else if (this->Type == SavType::_NDS && Name == "Slot" && Index >= 0 && Index <= 2) {
+			Op.Section = SavSection::NDSSlot;
+
+		} else if (this->Type == SavType::_NDS && Name == "Painting" && Index >= 0 && Index < 20) {
+			Op.Section = SavSection::NDSPainting;
+
+		} else {
+			return false;
+		}
+
+		Op.Index = Index;
+
+		/* The Record, if there is one. */
+		std::string RecName = "";
+		int RecIdx = 0;
+		if (Parts.size() == 3) SplitIndex(Parts[1], RecName, RecIdx);
+
+		const std::vector<SavRecord> &Records = SavLayout::Records(Op.Section);
+		for (uint8_t Rec = 0; Rec < Records.size(); Rec++) {
+			if (RecName != Records[Rec].Name) continue;
+			if (Parts.size() == 3 && (RecIdx < 0 || RecIdx >= Records[Rec].Count)) return false;
+
+			for (uint8_t Field = 0; Field < Records[Rec].Fields.size(); Field++) {
+				if (Parts.back() != Records[Rec].Fields[Field].Name) continue;
+				if (Records[Rec].Fields[Field].ReadOnly) return false;
+
+				Op.Record = Rec;
+				Op.RecordIdx = (Parts.size() == 3 ? RecIdx : 0);
+				Op.Field = Field;
+				return true;
+			}
+		}
+
+		return false;
+	};
+
+
+	/*
+		Return, if a Patch operation points to an existing Field, which is not read only.
+
+		const SavPatchOp &Op: The operation.
+	*/
+	bool SavPatch::Valid(const SavPatchOp &Op) const {
+		if (this->Type == SavType::_GBA && Op.Section != SavSection::GBASettings && Op.Section != SavSection::GBASlot) return false;
+		if (this->Type == SavType::_NDS && Op.Section != SavSection::NDSSlot && Op.Section != SavSection::NDSPainting) return false;
+
+		/* The Index comes straight from the file on LoadBinary(), so check it against the Section. */
+		switch(Op.Section) {
+			case SavSection::GBASettings:
+				if (Op.Index != 0) return false;
+				break;
+
+			case SavSection::GBASlot:
+				if (Op.Index < 1 || Op.Index > 4) return false;
+				break;
+
+			case SavSection::NDSSlot:
+				if (Op.Index > 2) return false;
+				break;
+
+			case SavSection::NDSPainting:
+				if (Op.Index > 19) return false;
+				break;
+
+			default:
+				return false;
+		}
+
+		const std::vector<SavRecord> &Records = SavLayout::Records(Op.Section);
+		if (Op.Record >= Records.size() || Op.RecordIdx >= Records[Op.Record].Count || Op.Field >= Records[Op.Record].Fields.size()) return false;
+
+		return !Records[Op.Record].Fields[Op.Field].ReadOnly;
+	};
+
+
+	/*
+		Set a numeric Field.
+
+		const std::string &Path: The path of the Field.
+		const uint32_t V: The value. It gets clamped on Apply(), the same way as the setters do.
+
+		Returns false, if the path does not exist or the Field isn't numeric.
+	*/
+	bool SavPatch::Set(const std::string &Path, const uint32_t V) {
+		SavPatchOp Op;
+		if (!this->Resolve(Path, Op) || !SavLayout::Numeric(SavLayout::Records(Op.Section)[Op.Record].Fields[Op.Field])) return false;
+
+		Op.Value = V;
+		this->Ops.push_back(Op);
+		return true;
+	};
+
+
+	/*
+		Set a String Field.
+
+		const std::string &Path: The path of the Field.
+		const std::string &Str: The string.
+
+		Returns false, if the path does not exist or the Field isn't a String.
+	*/
+	bool SavPatch::Set(const std::string &Path, const std::string &Str) {
+		SavPatchOp Op;
+		if (!this->Resolve(Path, Op) || SavLayout::Records(Op.Section)[Op.Record].Fields[Op.Field].Type != SavFieldType::String) return false;
+
+		Op.Str = Str;
+		this->Ops.push_back(Op);
+		return true;
+	};
+
+
+	/*
+		A minimal JSON parser for Patch documents.
+
+		Accepts an Object of path -> value pairs, where values are unsigned integers, booleans or strings.
+		Nested Objects are joined with '.', so { "Slot1": { "Cast3": { "Friendly": 3 } } } is the same as { "Slot1.Cast3.Friendly": 3 }.
+	*/
+	class PatchParser {
+	public:
+		PatchParser(const std::string &JSON, SavPatch &Patch)
+			: JSON(JSON), Patch(Patch) { };
+
+		bool Parse() {
+			this->SkipSpace();
+			if (!this->Object("")) return false;
+
+			this->SkipSpace();
+			return this->Pos == this->JSON.size();
+		};
+	private:
+		const std::string &JSON;
+		SavPatch &Patch;
+		size_t Pos = 0;
+
+		void SkipSpace() {
+			while (this->Pos < this->JSON.size() && isspace((uint8_t)this->JSON[this->Pos])) this->Pos++;
+		};
+
+		bool Expect(const char C) {
+			this->SkipSpace();
+			if (this->Pos >= this->JSON.size() || this->JSON[this->Pos] != C) return false;
+
+			this->Pos++;
+			return true;
+		};
+
+		/* Append a code point as UTF-8. */
+		static void AppendUTF8(std::string &Str, const uint32_t C) {
+			if (C < 0x80) {
+				Str += (char)C;
+
+			} else if (C < 0x800) {
+				Str += (char)(0xC0 | (C >> 6));
+				Str += (char)(0x80 | (C & 0x3F));
+
+			} else if (C < 0x10000) {
+				Str += (char)(0xE0 | (C >> 12));
+				Str += (char)(0x80 | ((C >> 6) & 0x3F));
+				Str += (char)(0x80 | (C & 0x3F));
+
+			} else {
+				Str += (char)(0xF0 | (C >> 18));
+				Str += (char)(0x80 | ((C >> 12) & 0x3F));
+				Str += (char)(0x80 | ((C >> 6) & 0x3F));
+				Str += (char)(0x80 | (C & 0x3F));
+			}
+		};
+
+		/* The 4 hex digits of a \u escape. */
+		bool Hex4(uint32_t &CP) {
+			if (this->Pos + 4 > this->JSON.size()) return false;
+
+			CP = 0;
+			for (uint8_t Digit = 0; Digit < 4; Digit++) {
+				const char C = this->JSON[this->Pos++];
+
+				if (C >= '0' && C <= '9') CP = (CP << 4) | (C - '0');
+				else if (C >= 'a' && C <= 'f') CP = (CP << 4) | (C - 'a' + 0xA);
+				else if (C >= 'A' && C <= 'F') CP = (CP << 4) | (C - 'A' + 0xA);
+				else return false;
+			}
+
+			return true;
+		};
+
+		bool String(std::string &Str) {
+			if (!this->Expect('"')) return false;
+
+			while (this->Pos < this->JSON.size()) {
+				const char C = this->JSON[this->Pos++];
+				if (C == '"') return true;
+
+				if (C != '\\') {
+					Str += C;
+					continue;
+				}
+
+				if (this->Pos >= this->JSON.size()) return false;
+
+				switch(this->JSON[this->Pos++]) {
+					case 'n':
+						Str += '\n';
+						break;
+
+					case 't':
+						Str += '\t';
+						break;
+
+					case 'r':
+						Str += '\r';
+						break;
+
+					case 'b':
+						Str += '\b';
+						break;
+
+					case 'f':
+						Str += '\f';
+						break;
+
+					case '"':
+					case '\\':
+					case '/':
+						Str += this->JSON[this->Pos - 1];
+						break;
+
+					case 'u':
+						{
+							uint32_t CP = 0;
+							if (!this->Hex4(CP) || (CP >= 0xDC00 && CP <= 0xDFFF)) return false; // Lone low surrogate.
+
+							/* A high surrogate needs a low one right after it, together they are one code point. */
+							if (CP >= 0xD800 && CP <= 0xDBFF) {
+								uint32_t Low = 0;
+								if (this->JSON.compare(this->Pos, 2, "\\u") != 0) return false;
+
+								this->Pos += 2;
+								if (!this->Hex4(Low) || Low < 0xDC00 || Low > 0xDFFF) return false;
+
+								CP = 0x10000 + ((CP - 0xD800) << 10) + (Low - 0xDC00);
+							}
+
+							AppendUTF8(Str, CP);
+							break;
+						}
+
+					default: // Not a JSON escape.
+						return false;
+				}
+			}
+
+			return false;
+		};
+
+		bool Value(const std::string &Path) {
+			this->SkipSpace();
+			if (this->Pos >= this->JSON.size()) return false;
+
+			const char C = this->JSON[this->Pos];
+			if (C == '{') return this->Object(Path + ".");
+
+			if (C == '"') {
+				std::string Str;
+				return this->String(Str) && this->Patch.Set(Path, Str);
+			}
+
+			if (this->JSON.compare(this->Pos, 4, "true") == 0 || this->JSON.compare(this->Pos, 5, "false") == 0) {
+				this->Pos += (C == 't' ? 4 : 5);
+				return this->Patch.Set(Path, (uint32_t)(C == 't'));
+			}
+
+			if (!isdigit((uint8_t)C)) return false;
+
+			uint64_t V = 0;
+			while (this->Pos < this->JSON.size() && isdigit((uint8_t)this->JSON[this->Pos])) {
+				V = std::min<uint64_t>(0xFFFFFFFF, (V * 10) + (this->JSON[this->Pos++] - '0'));
+			}
+
+			return this->Patch.Set(Path, (uint32_t)V);
+		};
+
+		bool Object(const std::string &Prefix) {
+			if (!this->Expect('{')) return false;
+			if (this->Expect('}')) return true;
+
+			do {
+				std::string Key;
+				if (!this->String(Key) || !this->Expect(':') || !this->Value(Prefix + Key)) return false;
+			} while (this->Expect(','));
+
+			return this->Expect('}');
+		};
+	};
+
+
+	/*
+		Add all operations of a JSON Patch document.
+
+		const std::string &JSON: The document.
+
+		Returns false if the document is malformed or contains an unknown path. Operations before the error are kept.
+	*/
+	bool SavPatch::LoadJSON(const std::string &JSON) {
+		PatchParser Parser(JSON, *this);
+		return Parser.Parse();
+	};
+
+
+	/*
+		Add all operations of a binary Patch.
+
+		const uint8_t *Data: The binary Patch.
+		const size_t Size: The size of the binary Patch.
+
+		Returns false if it is malformed or for another SavType.
+	*/
+	bool SavPatch::LoadBinary(const uint8_t *Data, const size_t Size) {
+		if (!Data || Size < 0xC || memcmp(Data, this->Magic, 4) || Data[0x4] != this->Version || Data[0x5] != (uint8_t)this->Type) return false;
+
+		const uint32_t Count = DataHelper::Read<uint32_t>(Data, 0x8);
+		size_t Pos = 0xC;
+
+		for (uint32_t Idx = 0; Idx < Count; Idx++) {
+			if (Pos + 5 > Size) return false;
+
+			SavPatchOp Op;
+			Op.Section = (SavSection)Data[Pos];
+			Op.Index = Data[Pos + 1];
+			Op.Record = Data[Pos + 2];
+			Op.RecordIdx = Data[Pos + 3];
+			Op.Field = Data[Pos + 4];
+			Pos += 5;
+
+			if (!this->Valid(Op)) return false;
+
+			if (SavLayout::Records(Op.Section)[Op.Record].Fields[Op.Field].Type == SavFieldType::String) {
+				if (Pos + 1 > Size || Pos + 1 + Data[Pos] > Size) return false;
+
+				Op.Str.assign((const char *)Data + Pos + 1, Data[Pos]);
+				Pos += 1 + Data[Pos];
+
+			} else {
+				if (Pos + 4 > Size) return false;
+
+				Op.Value = DataHelper::Read<uint32_t>(Data, Pos);
+				Pos += 4;
+			}
+
+			this->Ops.push_back(Op);
+		}
+
+		return true;
+	};
+
+
+	/* Return the binary form of the Patch. */
+	std::vector<uint8_t> SavPatch::Binary() const {
+		std::vector<uint8_t> Res(0xC, 0x0);
+		memcpy(Res.data(), this->Magic, 4);
+		Res[0x4] = this->Version;
+		Res[0x5] = (uint8_t)this->Type;
+		DataHelper::Write<uint32_t>(Res.data(), 0x8, this->Ops.size());
+
+		for (const SavPatchOp &Op : this->Ops) {
+			Res.insert(Res.end(), { (uint8_t)Op.Section, Op.Index, Op.Record, Op.RecordIdx, Op.Field });
+
+			if (SavLayout::Records(Op.Section)[Op.Record].Fields[Op.Field].Type == SavFieldType::String) {
+				const uint8_t Length = std::min<size_t>(0xFF, Op.Str.size());
+				Res.push_back(Length);
+				Res.insert(Res.end(), Op.Str.begin(), Op.Str.begin() + Length);
+
+			} else {
+				const size_t Pos = Res.size();
+				Res.resize(Pos + 4);
+				DataHelper::Write<uint32_t>(Res.data(), Pos, Op.Value);
+			}
+		}
+
+		return Res;
+	};
+
+
+	/*
+		Apply the Patch to a SAV.
+
+		SAV &Sav: The SAV to apply to. It has to be of the same type as the Patch.
+
+		Returns the amount of applied operations. Operations on Slots which don't exist or on House Items past the Item count are skipped,
+		so are illegal values of Fields whose setter ignores them (SavField::Strict).
+	*/
+	uint32_t SavPatch::Apply(SAV &Sav) const {
+		if (!Sav.GetValid() || Sav.GetReadOnly() || Sav.GetType() != this->Type) return 0;
+
+		uint8_t *Data = Sav.GetData();
+		const std::vector<SavSectionRef> Refs = SavLayout::Sections(Sav);
+
+		/* Look up the Sections and their House Item count once. */
+		int8_t Lookup[4][20];
+		memset(Lookup, -1, sizeof(Lookup));
+		std::vector<uint8_t> HouseItems(Refs.size()), Touched(Refs.size(), 0x0);
+		std::vector<std::pair<uint8_t, uint8_t>> Tallies; // Section, Record.
+
+		for (uint8_t Idx = 0; Idx < Refs.size(); Idx++) {
+			Lookup[(uint8_t)Refs[Idx].Section][Refs[Idx].Index] = Idx;
+			HouseItems[Idx] = SavLayout::HouseItems(Data, Refs[Idx]);
+		}
+
+		uint32_t Applied = 0;
+		for (const SavPatchOp &Op : this->Ops) {
+			const int8_t RefIdx = Lookup[(uint8_t)Op.Section][Op.Index];
+			if (RefIdx == -1) continue;
+
+			const SavSectionRef &Ref = Refs[RefIdx];
+			const SavRecord &Rec = SavLayout::Records(Op.Section)[Op.Record];
+			const SavField &Field = Rec.Fields[Op.Field];
+			if (Op.RecordIdx >= SavLayout::RecordCount(Data, Ref, Rec)) continue;
+
+			const uint32_t Offs = SavLayout::FieldOffs(Ref, Rec, Field, Op.RecordIdx, HouseItems[RefIdx]);
+
+			if (Field.Type == SavFieldType::String) {
+				DataHelper::WriteString(Data, Offs, Field.Width, Op.Str, Sav.GetRegion());
+
+			} else {
+				if (Field.Strict && !SavLayout::Legal(Field, Op.Value)) continue; // Ignored, like the setter does.
+
+				const uint32_t V = SavLayout::Clamp(Field, Op.Value);
+				SavLayout::Write(Data, Offs, Field, V, Op.RecordIdx);
+
+				if (Field.Mirror) {
+					Data[Ref.Offs + Field.Mirror] = (uint8_t)V;
+					Sav.MarkDirty(Ref.Offs + Field.Mirror, 1);
+				}
+			}
+
+			Sav.MarkDirty(Offs, SavLayout::Size(Field));
+
+			if (Rec.TallyOffs) {
+				const std::pair<uint8_t, uint8_t> Tally = { RefIdx, Op.Record };
+				if (std::find(Tallies.begin(), Tallies.end(), Tally) == Tallies.end()) Tallies.push_back(Tally);
+			}
+
+			Touched[RefIdx] = 0x1;
+			Applied++;
+		}
+
+		if (!Applied) return 0;
+
+		/* Update the Item counts and fix the Checksums once. */
+		for (const std::pair<uint8_t, uint8_t> &Tally : Tallies) {
+			const SavRecord &Rec = SavLayout::Records(Refs[Tally.first].Section)[Tally.second];
+
+			SavLayout::Tally(Data, Refs[Tally.first], Rec);
+			Sav.MarkDirty(Refs[Tally.first].Offs + Rec.TallyOffs, 1);
+		}
+
+		for (uint8_t Idx = 0; Idx < Refs.size(); Idx++) {
+			if (!Touched[Idx]) continue;
+
+			SavLayout::FixChecksums(Data, Refs[Idx]);
+			for (const SavChecksum &CHKS : SavLayout::Checksums(Refs[Idx].Section)) Sav.MarkDirty(Refs[Idx].Offs + CHKS.Offs, 2);
+		}
+
+		Sav.SetChangesMade(true);
+		return Applied;
+	};
+};
\ No newline at end of file
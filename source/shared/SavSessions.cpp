@@ -0,0 +1,313 @@
+/*
+*   This file is part of Sim2Editor-CPPCore
+*   Copyright (C) 2020-2021 Sim2Team
+*
+*   This program is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Additional Terms 7.b and 7.c of GPLv3 apply to this file:
+*       * Requiring preservation of specified reasonable legal notices or
+*         author attributions in that material or in the Appropriate Legal
+*         Notices displayed by works containing it.
+*       * Prohibiting misrepresentation of the origin of that material,
+*         or requiring that modified versions of such material be marked in
+*         reasonable ways as different from the original version.
+*/
+
+#include "SavSessions.hpp"
+#include "SavUtils.hpp"
+#include <sys/stat.h>
+
+
+namespace S2Core {
+	/* Return the mtime of a file in nanoseconds, or -1 if it does not exist. */
+	static int64_t MTime(const std::string &Path) {
+		struct stat Info;
+		if (stat(Path.c_str(), &Info) != 0) return -1;
+
+		#ifdef __APPLE__
+			return (int64_t)Info.st_mtimespec.tv_sec * 1000000000 + Info.st_mtimespec.tv_nsec;
+		#else
+			return (int64_t)Info.st_mtim.tv_sec * 1000000000 + Info.st_mtim.tv_nsec;
+		#endif
+	};
+
+
+	/* Write back and unload everything. */
+	SavSessions::~SavSessions() {
+		while (!this->Sessions.empty()) this->Close(this->Sessions.begin()->first);
+	};
+
+
+	/* Return the SAV of a loaded session, also if it is the active one. */
+	SAV *SavSessions::Current(const SavHandle Handle) const {
+		if (Handle == this->Active) return SavUtils::Sav.get();
+
+		auto It = this->Sessions.find(Handle);
+		return (It != this->Sessions.end() ? It->second.Sav.get() : nullptr);
+	};
+
+
+	/* Move a loaded session to the front of the LRU. */
+	void SavSessions::Touch(Session &S) {
+		if (S.Loaded) this->LRU.splice(this->LRU.begin(), this->LRU, S.Pos);
+	};
+
+
+	/*
+		Load the SavFile of a session. If it is loaded already, it gets replaced, and stays the active one if it was.
+		Nothing changes, if the SavFile isn't a valid Sav.
+	*/
+	bool SavSessions::Load(const SavHandle Handle, Session &S) {
+		const SavStats::Scope StatScope(&S.Stats);
+		std::unique_ptr<SAV> Sav = std::make_unique<SAV>(S.Path);
+		if (!Sav->GetValid()) return false;
+
+		const bool WasActive = (Handle == this->Active);
+		this->Unload(Handle, S);
+
+		S.MTime = MTime(S.Path);
+		this->Used += Sav->GetFileSize();
+		S.Sav = std::move(Sav);
+		S.Loaded = true;
+
+		this->LRU.push_front(Handle);
+		S.Pos = this->LRU.begin();
+
+		if (WasActive) {
+			SavUtils::Sav = std::move(S.Sav);
+			this->ActiveSav = SavUtils::Sav.get();
+			this->Active = Handle;
+		}
+
+		this->Evict(Handle);
+		return true;
+	};
+
+
+	/* Unload a session, without writing it back. */
+	void SavSessions::Unload(const SavHandle Handle, Session &S) {
+		if (!S.Loaded) return;
+
+		if (Handle == this->Active) {
+			S.Sav = std::move(SavUtils::Sav);
+			this->Active = 0;
+			this->ActiveSav = nullptr;
+			if (SavStats::Bound() == &S.Stats) SavStats::Bind(nullptr);
+		}
+
+		this->Used -= S.Sav->GetFileSize();
+		S.Sav = nullptr;
+		S.Loaded = false;
+		this->LRU.erase(S.Pos);
+	};
+
+
+	/* Unload a session and forget about it, without writing it back. */
+	void SavSessions::Drop(const SavHandle Handle) {
+		auto It = this->Sessions.find(Handle);
+		if (It == this->Sessions.end()) return;
+
+		this->Unload(Handle, It->second);
+		this->Paths.erase(It->second.Path);
+		this->Sessions.erase(It);
+	};
+
+
+	/*
+		Close the least recently used sessions, until the budget fits again.
+
+		const SavHandle Keep: A session, which should stay loaded no matter what.
+	*/
+	void SavSessions::Evict(const SavHandle Keep) {
+		auto It = this->LRU.end();
+
+		while (this->Used > this->Budget && It != this->LRU.begin()) {
+			const SavHandle Handle = *(--It);
+			if (Handle == Keep || Handle == this->Active) continue;
+
+			Session &S = this->Sessions[Handle];
+			if (S.Sav->GetChangesMade() && !this->Flush(Handle)) continue; // Keep, what can't be written back.
+
+			It = std::next(It); // Drop() erases the current position.
+			this->Drop(Handle);
+		}
+	};
+
+
+	/*
+		Open a SavFile.
+
+		const std::string &Path: The path to the SavFile.
+
+		Returns the handle, or 0 if it isn't a valid Sav or on a conflict (see Conflict()).
+		Opening the same path again returns the same handle, as long as the session is open.
+	*/
+	SavHandle SavSessions::Open(const std::string &Path) {
+		auto Known = this->Paths.find(Path);
+
+		if (Known != this->Paths.end()) {
+			Session &S = this->Sessions[Known->second];
+
+			/* Changed on disk, while we have changes as well. Don't pick a side. */
+			if (this->Conflict(Known->second)) return 0;
+
+			/* Still loaded and unchanged on disk. */
+			if (S.Loaded && S.MTime == MTime(Path)) {
+				this->Touch(S);
+				return Known->second;
+			}
+
+			/* Changed on disk, so load it again. The active session is never unloaded, so it keeps the old data if that fails. */
+			const SavHandle Handle = Known->second;
+			if (this->Load(Handle, S)) return Handle;
+
+			if (Handle != this->Active) this->Drop(Handle);
+			return 0;
+		}
+
+		const SavHandle Handle = this->Next++;
+		Session &S = this->Sessions[Handle];
+		S.Path = Path;
+
+		if (!this->Load(Handle, S)) {
+			this->Sessions.erase(Handle);
+			return 0;
+		}
+
+		this->Paths[Path] = Handle;
+		return Handle;
+	};
+
+
+	/*
+		Return the SAV of a session.
+
+		const SavHandle Handle: The session handle.
+
+		Returns nullptr, if the handle is invalid, for example because the session got closed to fit the budget.
+	*/
+	SAV *SavSessions::Get(const SavHandle Handle) {
+		auto It = this->Sessions.find(Handle);
+		if (It == this->Sessions.end() || !It->second.Loaded) return nullptr;
+
+		this->Touch(It->second);
+		return this->Current(Handle);
+	};
+
+
+	/*
+		Make a session the SavUtils::Sav, so the GBA* / NDS* classes work on it.
+
+		const SavHandle Handle: The session handle.
+
+		Returns false, if the handle is invalid, or if SavUtils::Sav holds a SAV which isn't one of the sessions
+		(for example from SavUtils::LoadSav()), as that one would be lost. Finish or reset it first.
+	*/
+	bool SavSessions::Activate(const SavHandle Handle) {
+		if (SavUtils::Sav && SavUtils::Sav.get() != this->ActiveSav) return false;
+		if (Handle == this->Active) return this->Get(Handle) != nullptr;
+		if (!this->Get(Handle)) return false;
+
+		/* Give the previous one back. */
+		if (this->Active) this->Sessions[this->Active].Sav = std::move(SavUtils::Sav);
+
+		SavUtils::Sav = std::move(this->Sessions[Handle].Sav);
+		SavStats::Bind(&this->Sessions[Handle].Stats);
+		this->ActiveSav = SavUtils::Sav.get();
+		this->Active = Handle;
+		return true;
+	};
+
+
+	/*
+		Write a session back to its SavFile, if it has changes.
+
+		const SavHandle Handle: The session handle.
+		const SavWriteMode Mode: How to write (Optional).
+	*/
+	bool SavSessions::Flush(const SavHandle Handle, const SavWriteMode Mode) {
+		auto It = this->Sessions.find(Handle);
+		if (It == this->Sessions.end()) return false;
+
+		SAV *Sav = this->Current(Handle);
+		if (!It->second.Loaded || !Sav || !Sav->GetChangesMade()) return true;
+		if (this->Conflict(Handle)) return false; // Don't overwrite what someone else wrote.
+		const SavStats::Scope StatScope(&It->second.Stats);
+		S2CORE_STAT(Finishes, 1);
+		S2CORE_STAT_TIMER(FinishNanos);
+
+		uint32_t Written = 0;
+		if (!SavWriter::Write(*Sav, Mode, Written)) return false;
+
+		It->second.MTime = MTime(It->second.Path);
+		return true;
+	};
+
+
+	/*
+		Write back and close a session. The handle is invalid afterwards.
+
+		const SavHandle Handle: The session handle.
+
+		Returns false, if writing back failed or on a conflict. The session is closed anyway.
+	*/
+	bool SavSessions::Close(const SavHandle Handle) {
+		if (this->Sessions.find(Handle) == this->Sessions.end()) return false;
+
+		const bool Res = this->Flush(Handle);
+		this->Drop(Handle);
+		return Res;
+	};
+
+
+	/*
+		Return, if the SavFile of a session changed on disk, while the session has unwritten changes.
+
+		const SavHandle Handle: The session handle.
+	*/
+	bool SavSessions::Conflict(const SavHandle Handle) const {
+		auto It = this->Sessions.find(Handle);
+		if (It == this->Sessions.end() || !It->second.Loaded) return false;
+
+		const SAV *Sav = this->Current(Handle);
+		return (Sav && Sav->GetChangesMade() && It->second.MTime != MTime(It->second.Path));
+	};
+
+
+	/*
+		Return the SavStats counters of a session.
+
+		const SavHandle Handle: The session handle.
+		const bool Clear: If the counters of the session should be reset as well (Optional).
+
+		Returns zeros, if the handle is invalid or the Core isn't built with S2CORE_STATS.
+	*/
+	SavStatsData SavSessions::Stats(const SavHandle Handle, const bool Clear) {
+		auto It = this->Sessions.find(Handle);
+		if (It == this->Sessions.end()) return { };
+
+		return It->second.Stats.Stats(Clear);
+	};
+
+
+	/*
+		Change the memory budget, unloading sessions if needed.
+
+		const size_t Budget: The budget in bytes.
+	*/
+	void SavSessions::SetBudget(const size_t Budget) {
+		this->Budget = Budget;
+		this->Evict(0);
+	};
+};
\ No newline at end of file
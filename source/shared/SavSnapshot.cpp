@@ -0,0 +1,71 @@
+/*
+*   This file is part of Sim2Editor-CPPCore
+*   Copyright (C) 2020-2021 Sim2Team
+*
+*   This program is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Additional Terms 7.b and 7.c of GPLv3 apply to this file:
+*       * Requiring preservation of specified reasonable legal notices or
+*         author attributions in that material or in the Appropriate Legal
+*         Notices displayed by works containing it.
+*       * Prohibiting misrepresentation of the origin of that material,
+*         or requiring that modified versions of such material be marked in
+*         reasonable ways as different from the original version.
+*/
+
+#include "Sav.hpp"
+#include "SavSnapshot.hpp"
+
+
+namespace S2Core {
+	/*
+		Create an Epoch by copying the current SavBuffer.
+
+		const uint8_t *Data: The SavBuffer to copy.
+		const uint32_t Size: The size of the SavBuffer.
+		const uint64_t Generation: The Generation of the Epoch.
+	*/
+	SavEpoch::SavEpoch(const uint8_t *Data, const uint32_t Size, const uint64_t Generation) : Size(Size), Generation(Generation) {
+		this->Data = std::make_unique<uint8_t[]>(this->Size);
+		if (Data) memcpy(this->Data.get(), Data, this->Size);
+	};
+
+
+	/*
+		Pin the latest published Epoch of a SAV to the calling thread.
+
+		const SAV &Sav: The SAV to pin.
+
+		If nothing got published yet, nothing is pinned and Valid() returns false.
+	*/
+	SavSnapshot::SavSnapshot(const SAV &Sav) : Epoch(Sav.CurrentEpoch()) {
+		this->PrevData = SavSnapshot::PinnedData;
+		this->PrevSav = SavSnapshot::PinnedSav;
+		this->PrevBytes = SavSnapshot::PinnedBytes;
+
+		if (this->Valid()) {
+			SavSnapshot::PinnedData = this->Epoch->Data.get();
+			SavSnapshot::PinnedSav = &Sav;
+			SavSnapshot::PinnedBytes = this->Epoch->Size;
+		}
+	};
+
+
+	/* Unpin the Epoch again and restore the previous pin. */
+	SavSnapshot::~SavSnapshot() {
+		SavSnapshot::PinnedData = this->PrevData;
+		SavSnapshot::PinnedSav = this->PrevSav;
+		SavSnapshot::PinnedBytes = this->PrevBytes;
+	};
+};
\ No newline at end of file
@@ -0,0 +1,135 @@
+/*
+*   This file is part of Sim2Editor-CPPCore
+*   Copyright (C) 2020-2021 Sim2Team
+*
+*   This program is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Additional Terms 7.b and 7.c of GPLv3 apply to this file:
+*       * Requiring preservation of specified reasonable legal notices or
+*         author attributions in that material or in the Appropriate Legal
+*         Notices displayed by works containing it.
+*       * Prohibiting misrepresentation of the origin of that material,
+*         or requiring that modified versions of such material be marked in
+*         reasonable ways as different from the original version.
+*/
+
+#include "SavStats.hpp"
+
+
+namespace S2Core {
+	#ifdef S2CORE_STATS
+		std::atomic<uint64_t> SavStats::Counters[(size_t)SavStat::Count] = { };
+		thread_local SavStats::Sink *SavStats::BoundSink = nullptr;
+	#endif
+
+	/* Read a counter, and reset it in the same step if wanted. */
+	static uint64_t Take(const SavStat Counter, const bool Clear) {
+		#ifdef S2CORE_STATS
+			std::atomic<uint64_t> &Value = SavStats::Counters[(size_t)Counter];
+			return (Clear ? Value.exchange(0, std::memory_order_relaxed) : Value.load(std::memory_order_relaxed));
+
+		#else
+			(void)Counter;
+			(void)Clear;
+			return 0;
+		#endif
+	};
+
+
+	/* Fill a snapshot, with Get returning the value of a counter. */
+	template <typename F>
+	static SavStatsData Collect(F Get) {
+		SavStatsData Res;
+
+		Res.Reads = Get(SavStat::Reads);
+		Res.ReadBytes = Get(SavStat::ReadBytes);
+		Res.Writes = Get(SavStat::Writes);
+		Res.WriteBytes = Get(SavStat::WriteBytes);
+		Res.ViewReads = Get(SavStat::ViewReads);
+		Res.ViewReadBytes = Get(SavStat::ViewReadBytes);
+		Res.ViewWrites = Get(SavStat::ViewWrites);
+		Res.ViewWriteBytes = Get(SavStat::ViewWriteBytes);
+		Res.ChecksumRegions = Get(SavStat::ChecksumRegions);
+		Res.ChecksumBytes = Get(SavStat::ChecksumBytes);
+		Res.ViewAllocs = Get(SavStat::ViewAllocs);
+		Res.ItemShiftBytes = Get(SavStat::ItemShiftBytes);
+		Res.FileReadBytes = Get(SavStat::FileReadBytes);
+		Res.FileWriteBytes = Get(SavStat::FileWriteBytes);
+		Res.Finishes = Get(SavStat::Finishes);
+		Res.FinishNanos = Get(SavStat::FinishNanos);
+
+		return Res;
+	};
+
+
+	/*
+		Return a snapshot of all counters.
+
+		const bool Clear: If the counters should be reset as well (Optional).
+		Nothing that gets counted in between reading and resetting a counter gets lost.
+	*/
+	SavStatsData SavStats::Stats(const bool Clear) {
+		return Collect([Clear](const SavStat Counter) { return Take(Counter, Clear); });
+	};
+
+
+	/* Reset all counters. */
+	void SavStats::Reset() {
+		SavStats::Stats(true);
+	};
+
+
+	/*
+		Return a snapshot of the counters of a Sink.
+
+		const bool Clear: If the counters should be reset as well (Optional).
+	*/
+	SavStatsData SavStats::Sink::Stats(const bool Clear) {
+		return Collect([this, Clear](const SavStat Counter) {
+			const uint64_t Value = this->Counters[(size_t)Counter];
+			if (Clear) this->Counters[(size_t)Counter] = 0;
+
+			return Value;
+		});
+	};
+
+
+	/* Return the Sink bound to the calling thread, or nullptr. */
+	SavStats::Sink *SavStats::Bound() {
+		#ifdef S2CORE_STATS
+			return SavStats::BoundSink;
+		#else
+			return nullptr;
+		#endif
+	};
+
+	/*
+		Bind a Sink to the calling thread, replacing the previous one.
+
+		Sink *Target: The Sink, or nullptr to unbind. It must outlive the binding.
+
+		Returns the previous Sink, so it can be bound again afterwards (see Scope).
+	*/
+	SavStats::Sink *SavStats::Bind(Sink *Target) {
+		#ifdef S2CORE_STATS
+			Sink *Prev = SavStats::BoundSink;
+			SavStats::BoundSink = Target;
+			return Prev;
+
+		#else
+			(void)Target;
+			return nullptr;
+		#endif
+	};
+};
\ No newline at end of file
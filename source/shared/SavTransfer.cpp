@@ -0,0 +1,236 @@
+/*
+*   This file is part of Sim2Editor-CPPCore
+*   Copyright (C) 2020-2021 Sim2Team
+*
+*   This program is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Additional Terms 7.b and 7.c of GPLv3 apply to this file:
+*       * Requiring preservation of specified reasonable legal notices or
+*         author attributions in that material or in the Appropriate Legal
+*         Notices displayed by works containing it.
+*       * Prohibiting misrepresentation of the origin of that material,
+*         or requiring that modified versions of such material be marked in
+*         reasonable ways as different from the original version.
+*/
+
+#include "Checksum.hpp"
+#include "DataHelper.hpp"
+#include "RLE.hpp"
+#include "Sav.hpp"
+#include "SavLayout.hpp"
+#include "SavTransfer.hpp"
+
+
+namespace S2Core {
+	/* If a physical NDS Slot has been written by the game at all, by checking the start of the Identifier. */
+	static bool NDSUsed(const uint8_t *Data, const uint8_t Physical) {
+		static constexpr uint8_t Start[4] = { 0x64, 0x61, 0x74, 0x0 };
+		return !memcmp(Data + (Physical * SavTransfer::SlotSize), Start, sizeof(Start));
+	};
+
+
+	/*
+		Return the physical Slot, which the next NDS Slot write goes to.
+
+		const SAV &Sav: The NDS SAV.
+
+		That is the first never used physical Slot, or else the one with the lowest save counter, which isn't the active location of a Slot.
+		Returns -1 if there is none.
+	*/
+	int8_t SavTransfer::NDSTargetSlot(const SAV &Sav) {
+		if (!Sav.GetValid() || Sav.GetType() != SavType::_NDS) return -1;
+
+		int8_t Target = -1;
+		uint32_t Oldest = 0xFFFFFFFF;
+
+		for (uint8_t Physical = 0; Physical < SavTransfer::NDSPhysicalSlots; Physical++) {
+			if (Sav.GetNDSSlot(0) == Physical || Sav.GetNDSSlot(1) == Physical || Sav.GetNDSSlot(2) == Physical) continue;
+			if (!NDSUsed(Sav.GetData(), Physical)) return Physical;
+
+			const uint32_t Count = DataHelper::Read<uint32_t>(Sav.GetData(), (Physical * SavTransfer::SlotSize) + 0x8);
+			if (Count < Oldest) {
+				Oldest = Count;
+				Target = Physical;
+			}
+		}
+
+		return Target;
+	};
+
+
+	/*
+		Write a 0x1000 byte Slot image to a Slot.
+
+		SAV &Dst: The SAV to write to.
+		const uint8_t DstSlot: The Slot to write to.
+		const uint8_t *Image: The Slot image. May point into Dst.
+		const bool Rotate: NDS only. If true, the image goes to the next physical Slot as a new save, like the game does it.
+		If false, it overwrites the active location of the Slot and keeps its header (Identifier, save counter, Slot).
+
+		Returns false if nothing got written.
+	*/
+	static bool WriteSlot(SAV &Dst, const uint8_t DstSlot, const uint8_t *Image, const bool Rotate) {
+		SavSectionRef Ref = { };
+		bool NewSave = false;
+
+		switch(Dst.GetType()) {
+			case SavType::_GBA:
+				if (DstSlot < 1 || DstSlot > 4) return false;
+
+				Ref = { SavSection::GBASlot, DstSlot, (uint32_t)(DstSlot * SavTransfer::SlotSize), SavTransfer::SlotSize };
+				break;
+
+			case SavType::_NDS: {
+				if (DstSlot > 2) return false;
+
+				NewSave = (Rotate || Dst.GetNDSSlot(DstSlot) == -1);
+				const int8_t Target = (NewSave ? SavTransfer::NDSTargetSlot(Dst) : Dst.GetNDSSlot(DstSlot));
+				if (Target == -1) return false;
+
+				Ref = { SavSection::NDSSlot, DstSlot, (uint32_t)(Target * SavTransfer::SlotSize), SavTransfer::SlotSize };
+				break;
+			}
+
+			case SavType::_NONE:
+			default:
+				return false;
+		}
+
+		uint8_t *To = Dst.GetData() + Ref.Offs;
+
+		if (Dst.GetType() == SavType::_NDS && !NewSave) {
+			memmove(To + 0x10, Image + 0x10, SavTransfer::SlotSize - 0x10); // Everything after the header.
+
+		} else if (To != Image) {
+			memmove(To, Image, SavTransfer::SlotSize);
+		}
+
+		if (NewSave) {
+			/* Take the Identifier of an existing Slot of Dst, so the Region byte stays the one of Dst. */
+			for (uint8_t Slot = 0; Slot < 3; Slot++) {
+				if (Dst.GetNDSSlot(Slot) == -1) continue;
+
+				memcpy(To, Dst.GetData() + (Dst.GetNDSSlot(Slot) * SavTransfer::SlotSize), 0x8);
+				break;
+			}
+
+			/* The next save counter, so the copy is the latest save of the Slot. */
+			uint32_t Newest = 0;
+			for (uint8_t Physical = 0; Physical < SavTransfer::NDSPhysicalSlots; Physical++) {
+				if (Physical != Ref.Offs / SavTransfer::SlotSize && NDSUsed(Dst.GetData(), Physical)) {
+					Newest = std::max<uint32_t>(Newest, DataHelper::Read<uint32_t>(Dst.GetData(), (Physical * SavTransfer::SlotSize) + 0x8));
+				}
+			}
+
+			DataHelper::Write<uint32_t>(To, 0x8, Newest + 1);
+			To[0xC] = DstSlot;
+			To[0xD] = 0x0;
+		}
+
+		SavLayout::FixChecksums(Dst.GetData(), Ref);
+		Dst.MarkDirty(Ref.Offs, Ref.Size);
+		if (!Dst.GetChangesMade()) Dst.SetChangesMade(true);
+
+		if (NewSave) Dst.ValidationCheck(); // Refresh the NDS Slot locations.
+		return true;
+	};
+
+
+	/*
+		Copy a Slot.
+
+		const SAV &Src: The SAV to copy from.
+		const uint8_t SrcSlot: The Slot to copy.
+		SAV &Dst: The SAV to copy to. Can be the same as Src.
+		const uint8_t DstSlot: The Slot to copy to. It gets overwritten on GBA, on NDS it gets a newer save.
+
+		Both SAVs have to be of the same type, and of the same Region on NDS, as the names are stored differently.
+		The copied block is marked dirty and its Checksums fixed, the NDS Slot locations of Dst get refreshed.
+
+		Returns false if nothing got copied.
+	*/
+	bool SavTransfer::CopySlot(const SAV &Src, const uint8_t SrcSlot, SAV &Dst, const uint8_t DstSlot) {
+		if (!Src.GetValid() || !Dst.GetValid() || Dst.GetReadOnly() || Src.GetType() != Dst.GetType()) return false;
+		if (!Src.SlotExist(SrcSlot)) return false;
+		if (Src.GetType() == SavType::_NDS && Src.GetRegion() != Dst.GetRegion()) return false;
+
+		const uint8_t Physical = (Src.GetType() == SavType::_NDS ? Src.GetNDSSlot(SrcSlot) : SrcSlot);
+		return WriteSlot(Dst, DstSlot, Src.GetData() + (Physical * SavTransfer::SlotSize), true);
+	};
+
+
+	/*
+		Export a Slot to the single Slot format, see SavTransfer.hpp.
+
+		const SAV &Sav: The SAV.
+		const uint8_t Slot: The Slot to export.
+
+		Returns an empty vector, if the Slot doesn't exist.
+	*/
+	std::vector<uint8_t> SavTransfer::ExportSlot(const SAV &Sav, const uint8_t Slot) {
+		if (!Sav.GetValid() || !Sav.SlotExist(Slot)) return { };
+
+		const uint8_t Physical = (Sav.GetType() == SavType::_NDS ? Sav.GetNDSSlot(Slot) : Slot);
+		const uint8_t *Image = Sav.GetData() + (Physical * SavTransfer::SlotSize);
+		const std::vector<uint8_t> Packed = RLE::Compress(Image, SavTransfer::SlotSize);
+		const bool Compressed = (Packed.size() < SavTransfer::SlotSize);
+		const uint32_t PayloadSize = (Compressed ? Packed.size() : SavTransfer::SlotSize);
+
+		std::vector<uint8_t> Res(SavTransfer::HeaderSize + PayloadSize, 0x0);
+		memcpy(Res.data(), SavTransfer::Magic, 4);
+		Res[0x4] = SavTransfer::Version;
+		Res[0x5] = (uint8_t)Sav.GetType();
+		Res[0x6] = (uint8_t)Sav.GetRegion();
+		Res[0x7] = (Compressed ? 0x1 : 0x0);
+		DataHelper::Write<uint64_t>(Res.data(), 0x8, Checksum::Hash(Image, SavTransfer::SlotSize));
+		DataHelper::Write<uint32_t>(Res.data(), 0x10, PayloadSize);
+		memcpy(Res.data() + SavTransfer::HeaderSize, (Compressed ? Packed.data() : Image), PayloadSize);
+
+		return Res;
+	};
+
+
+	/*
+		Import a Slot from the single Slot format.
+
+		SAV &Sav: The SAV.
+		const uint8_t Slot: The Slot to import to. On NDS, the active location of the Slot gets overwritten,
+		or if the Slot doesn't exist yet, the Slot gets created like CopySlot() does it.
+		const uint8_t *Data: The exported Slot.
+		const size_t Size: The size of Data.
+
+		The file is fully checked (type, Region, size and hash) before anything gets written.
+		Returns false if it didn't pass or nothing got written.
+	*/
+	bool SavTransfer::ImportSlot(SAV &Sav, const uint8_t Slot, const uint8_t *Data, const size_t Size) {
+		if (!Sav.GetValid() || Sav.GetReadOnly() || !Data || Size < SavTransfer::HeaderSize) return false;
+		if (memcmp(Data, SavTransfer::Magic, 4) || Data[0x4] != SavTransfer::Version || Data[0x5] != (uint8_t)Sav.GetType()) return false;
+		if (Sav.GetType() == SavType::_NDS && Data[0x6] != (uint8_t)Sav.GetRegion()) return false;
+
+		const uint32_t PayloadSize = DataHelper::Read<uint32_t>(Data, 0x10);
+		if (PayloadSize != Size - SavTransfer::HeaderSize) return false;
+
+		uint8_t Image[SavTransfer::SlotSize];
+		if (Data[0x7] & 0x1) {
+			if (!RLE::Decompress(Data + SavTransfer::HeaderSize, PayloadSize, Image, SavTransfer::SlotSize)) return false;
+
+		} else {
+			if (PayloadSize != SavTransfer::SlotSize) return false;
+			memcpy(Image, Data + SavTransfer::HeaderSize, SavTransfer::SlotSize);
+		}
+
+		if (Checksum::Hash(Image, SavTransfer::SlotSize) != DataHelper::Read<uint64_t>(Data, 0x8)) return false;
+		return WriteSlot(Sav, Slot, Image, false);
+	};
+};
\ No newline at end of file
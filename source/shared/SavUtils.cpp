@@ -24,9 +24,16 @@
 *         reasonable ways as different from the original version.
 */
 
+#include "BackupStore.hpp"
+#include "Checksum.hpp"
 #include "SavUtils.hpp"
-#include <ctime>
+#include "SavWriter.hpp"
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
 #include <unistd.h>
+#include <unordered_map>
 
 
 namespace S2Core {
@@ -45,7 +52,7 @@ namespace S2Core {
 		SavUtils::Sav = std::make_unique<SAV>(File);
 
 		if (SavUtils::Sav->GetType() != SavType::_NONE) {
-			if (DoBackup && SavUtils::Sav->GetValid()) SavUtils::CreateBackup(BasePath); // Create Backup, if true.
+			if (DoBackup && SavUtils::Sav->GetValid()) SavUtils::CreateBackup(BasePath, true); // Create Backup, if true.
 		}
 
 		return SavUtils::Sav->GetType();
@@ -66,7 +73,7 @@ namespace S2Core {
 		SavUtils::Sav = std::make_unique<SAV>(Data, Size);
 
 		if (SavUtils::Sav->GetType() != SavType::_NONE) {
-			if (DoBackup && SavUtils::Sav->GetValid()) SavUtils::CreateBackup(BasePath); // Create Backup, if true.
+			if (DoBackup && SavUtils::Sav->GetValid()) SavUtils::CreateBackup(BasePath, true); // Create Backup, if true.
 		}
 
 		return SavUtils::Sav->GetType();
@@ -74,75 +81,201 @@ namespace S2Core {
 
 
 	/*
-		Create a Backup of the current loaded Sav.
+		Load a Sav from caller owned memory, without copying it.
 
-		const std::string &BasePath: The base path where to create the Backups.
+		uint8_t *Data: The raw Save Buffer, which has to outlive the Sav.
+		const uint32_t Size: The Save Buffer Size.
 
-		Backup Format would be: 'Sims2-Year.Month.Day-Hour.Minute.Second.Sav'
+		Returns the SavType of the detected Save.
 	*/
-	bool SavUtils::CreateBackup(const std::string &BasePath) {
-		if (!SavUtils::Sav || SavUtils::Sav->GetValid()) return false;
-
-		std::string BackupPath = BasePath + "/Backups/"; // Base path.
-		bool CreateIt = false;
-
-		/* Fetch Time there. */
-		time_t Rawtime;
-		struct tm *TimeInfo;
-		char TimeBuffer[80];
-		time(&Rawtime);
-		TimeInfo = localtime(&Rawtime);
-		strftime(TimeBuffer, sizeof(TimeBuffer),"%Y.%m.%d-%H.%M.%S", TimeInfo); // Get the Time as String.
-
-		switch(SavUtils::Sav->GetType()) {
-			case SavType::_GBA:
-				BackupPath += "GBA/Sims2-" + std::string(TimeBuffer) + ".Sav";
-				CreateIt = true;
-				break;
-
-			case SavType::_NDS:
-				BackupPath += "NDS/Sims2-" + std::string(TimeBuffer) + ".Sav";
-				CreateIt = true;
-				break;
-
-			case SavType::_NONE:
-				break;
+	SavType SavUtils::LoadSav(uint8_t *Data, const uint32_t Size) {
+		SavUtils::Sav = std::make_unique<SAV>(Data, Size);
+		return SavUtils::Sav->GetType();
+	};
+
+
+	/*
+		Load a Sav from caller owned, read only memory, without copying it. All writes get refused.
+
+		const uint8_t *Data: The raw Save Buffer, which has to outlive the Sav.
+		const uint32_t Size: The Save Buffer Size.
+
+		Returns the SavType of the detected Save.
+	*/
+	SavType SavUtils::LoadSav(const uint8_t *Data, const uint32_t Size) {
+		SavUtils::Sav = std::make_unique<SAV>(Data, Size);
+		return SavUtils::Sav->GetType();
+	};
+
+
+	/*
+		Load a Sav straight from a reader, refusing anything that isn't a Sims 2 Sav early.
+
+		const SavReader &Reader: The reader, see SAV::SAV(const SavReader &, const uint32_t).
+		const uint32_t SizeHint: The expected size, if known (Optional).
+		const std::string &BasePath: The base path where to create the Backups (Optional).
+		const bool DoBackup: If creating a backup or not after loading the SavFile (Optional).
+
+		Returns the SavType of the detected Save.
+	*/
+	SavType SavUtils::LoadSav(const SavReader &Reader, const uint32_t SizeHint, const std::string &BasePath, const bool DoBackup) {
+		SavUtils::Sav = std::make_unique<SAV>(Reader, SizeHint);
+
+		if (SavUtils::Sav->GetType() != SavType::_NONE) {
+			if (DoBackup && SavUtils::Sav->GetValid()) SavUtils::CreateBackup(BasePath, true); // Create Backup, if true.
 		}
 
-		if (CreateIt) {
-			FILE *Out = fopen(BackupPath.c_str(), "w");
+		return SavUtils::Sav->GetType();
+	};
 
-			if (Out) {
-				fwrite(SavUtils::Sav->GetData(), 1, SavUtils::Sav->GetSize(), Out);
-				fclose(Out);
+
+	/*
+		The background Backup writer.
+
+		Jobs hold a private copy of the SavBuffer, so the editor can keep working on the live buffer while the Backup gets written.
+		A Backup whose content hash matches the last Backup of the same base path and SavType is skipped.
+	*/
+	class BackupWriter {
+	public:
+		~BackupWriter() {
+			{
+				std::lock_guard<std::mutex> Lock(this->Mutex);
+				this->Stop = true;
+			}
+
+			this->Wake.notify_all();
+			if (this->Worker.joinable()) this->Worker.join(); // Pending Backups still get written.
+		};
+
+		void Queue(const std::string &BasePath, const SavType Type, std::shared_ptr<const SavEpoch> Epoch) {
+			{
+				std::lock_guard<std::mutex> Lock(this->Mutex);
+				this->Jobs.push_back({ BasePath, Type, std::move(Epoch) });
+				if (!this->Worker.joinable()) this->Worker = std::thread(&BackupWriter::Run, this);
+			}
+
+			this->Wake.notify_all();
+		};
+
+		/* Wait for all queued Backups. */
+		void Wait() {
+			std::unique_lock<std::mutex> Lock(this->Mutex);
+			this->Idle.wait(Lock, [this]() { return this->Jobs.empty() && !this->Busy; });
+		};
+
+		/* Wait for all queued Backups, returns false if any of them failed since the last Flush(). */
+		bool Flush() {
+			this->Wait();
+
+			std::lock_guard<std::mutex> Lock(this->Mutex);
+			const bool Res = !this->Failed;
+			this->Failed = false;
+			return Res;
+		};
+
+		/* Write a Backup right away, returns false if it failed. */
+		bool Write(const std::string &BasePath, const SavType Type, const uint8_t *Data, const uint32_t Size) {
+			std::lock_guard<std::mutex> Lock(this->StoreMutex);
+			const std::string Key = BasePath + (Type == SavType::_GBA ? "/GBA" : "/NDS");
+			const uint64_t Hash = Checksum::Hash(Data, Size);
+
+			auto It = this->LastHash.find(Key);
+			if (It != this->LastHash.end() && It->second == Hash) return true;
+
+			BackupStore Store(BasePath);
+			if (Store.Store(Data, Size, Type) == "") return false;
+
+			this->LastHash[Key] = Hash;
+			return true;
+		};
+	private:
+		struct Job {
+			std::string BasePath;
+			SavType Type;
+			std::shared_ptr<const SavEpoch> Epoch;
+		};
+
+		std::mutex Mutex, StoreMutex;
+		std::condition_variable Wake, Idle;
+		std::deque<Job> Jobs;
+		std::thread Worker;
+		std::unordered_map<std::string, uint64_t> LastHash; // Protected by StoreMutex.
+		bool Stop = false, Busy = false, Failed = false;
+
+		void Run() {
+			std::unique_lock<std::mutex> Lock(this->Mutex);
+
+			while (true) {
+				this->Wake.wait(Lock, [this]() { return this->Stop || !this->Jobs.empty(); });
+				if (this->Jobs.empty()) return; // Stopped and nothing left to do.
+
+				Job Current = std::move(this->Jobs.front());
+				this->Jobs.pop_front();
+				this->Busy = true;
+
+				Lock.unlock();
+				const bool Good = this->Write(Current.BasePath, Current.Type, Current.Epoch->Data.get(), Current.Epoch->Size);
+				Lock.lock();
+
+				if (!Good) this->Failed = true;
+				this->Busy = false;
+				if (this->Jobs.empty()) this->Idle.notify_all();
 			}
+		};
+	};
+
+	static BackupWriter Writer;
+
+
+	/*
+		Create a Backup of the current loaded Sav.
+
+		const std::string &BasePath: The base path where to create the Backups.
+		const bool Async: If the Backup should be written on a background thread. Use FlushBackups() to wait for it and to get the result.
+
+		Backups go into a BackupStore, so only the blocks which changed since the last Backup take up space.
+		Backup Format would be: 'Sims2-Year.Month.Day-Hour.Minute.Second.S2B', see BackupStore for more.
+	*/
+	bool SavUtils::CreateBackup(const std::string &BasePath, const bool Async) {
+		if (!SavUtils::Sav || !SavUtils::Sav->GetValid() || SavUtils::Sav->GetType() == SavType::_NONE) return false;
+
+		if (Async) {
+			/* A private copy, as publishing here would hand a possibly half done edit to all snapshot readers. */
+			Writer.Queue(BasePath, SavUtils::Sav->GetType(), std::make_shared<const SavEpoch>(SavUtils::Sav->GetData(), SavUtils::Sav->GetSize(), 0));
+			return true; // Queued, FlushBackups() tells if it got written.
 		}
 
-		return CreateIt;
+		Writer.Wait(); // Keep the Backup order.
+		return Writer.Write(BasePath, SavUtils::Sav->GetType(), SavUtils::Sav->GetData(), SavUtils::Sav->GetSize());
 	};
 
 
+	/* Wait until all Backups queued by CreateBackup() are written. Returns false, if any of them failed since the last call. */
+	bool SavUtils::FlushBackups() { return Writer.Flush(); };
+
+
 	/*
 		Finish Sav Editing and unload everything.
 
 		const bool Reset: If resetting the Sav Pointer to nullptr after the action or not (True by Default).
+		const SavWriteMode Mode: How to write the SavFile, see SavWriter (InPlace by Default).
+
+		Returns the amount of written bytes.
 	*/
-	void SavUtils::Finish(const bool Reset) {
-		if (!SavUtils::Sav || !SavUtils::Sav->GetValid() || SavUtils::Sav->GetPath() == "") return;
+	uint32_t SavUtils::Finish(const bool Reset, const SavWriteMode Mode) {
+		if (!SavUtils::Sav || !SavUtils::Sav->GetValid() || SavUtils::Sav->GetPath() == "") return 0;
+		S2CORE_STAT(Finishes, 1);
+		S2CORE_STAT_TIMER(FinishNanos);
+		uint32_t Written = 0;
 
 		/* Ensure that we made changes, otherwise writing is useless. */
 		if (SavUtils::Sav->GetChangesMade()) {
 			SavUtils::Sav->Finish(); // The Finish action.
-
-			FILE *Out = fopen(SavUtils::Sav->GetPath().c_str(), "rb+");
-
-			if (Out) {
-				fwrite(SavUtils::Sav->GetData(), 1, SavUtils::Sav->GetSize(), Out);
-				fclose(Out);
-			}
+			SavWriter::Write(*SavUtils::Sav, Mode, Written);
 		}
 
 		if (Reset) SavUtils::Sav = nullptr;
+		return Written;
 	};
 
 
@@ -172,6 +305,10 @@ namespace S2Core {
 		const uint8_t BitIndex: The bit index ( 0 - 7 ).
 	*/
 	const bool SavUtils::ReadBit(const uint32_t Offs, const uint8_t BitIndex) {
+		S2CORE_STAT(Reads, 1);
+		S2CORE_STAT(ReadBytes, 1);
+
+		if (SavUtils::Pinned()) return DataHelper::ReadBit(SavUtils::Pinned(), Offs, BitIndex);
 		if (!SavUtils::Sav || !SavUtils::Sav->GetValid() || BitIndex > 0x7) return false;
 
 		return DataHelper::ReadBit(SavUtils::Sav->GetData(), Offs, BitIndex);
@@ -185,10 +322,14 @@ namespace S2Core {
 		const bool IsSet: If the bit is set (1) or not (0).
 	*/
 	void SavUtils::WriteBit(const uint32_t Offs, const uint8_t BitIndex, const bool IsSet) {
-		if (!SavUtils::Sav || !SavUtils::Sav->GetValid() || BitIndex > 0x7) return;
+		if (!SavUtils::Sav || !SavUtils::Sav->GetValid() || SavUtils::Sav->GetReadOnly() || BitIndex > 0x7) return;
 
 		if (DataHelper::WriteBit(SavUtils::Sav->GetData(), Offs, BitIndex, IsSet)) {
+			S2CORE_STAT(Writes, 1);
+			S2CORE_STAT(WriteBytes, 1);
+
 			if (!SavUtils::Sav->GetChangesMade()) SavUtils::Sav->SetChangesMade(true);
+			SavUtils::Sav->MarkDirty(Offs, 1);
 		}
 	};
 
@@ -200,6 +341,10 @@ namespace S2Core {
 		const bool First: If reading from the first 4 bits, or the last 4.
 	*/
 	const uint8_t SavUtils::ReadBits(const uint32_t Offs, const bool First) {
+		S2CORE_STAT(Reads, 1);
+		S2CORE_STAT(ReadBytes, 1);
+
+		if (SavUtils::Pinned()) return DataHelper::ReadBits(SavUtils::Pinned(), Offs, First);
 		if (!SavUtils::Sav || !SavUtils::Sav->GetValid()) return 0;
 
 		return DataHelper::ReadBits(SavUtils::Sav->GetData(), Offs, First);
@@ -213,38 +358,50 @@ namespace S2Core {
 		const uint8_t Data: The Data to write.
 	*/
 	void SavUtils::WriteBits(const uint32_t Offs, const bool First, const uint8_t Data) {
-		if (!SavUtils::Sav || !SavUtils::Sav->GetValid() || Data > 0xF) return;
+		if (!SavUtils::Sav || !SavUtils::Sav->GetValid() || SavUtils::Sav->GetReadOnly() || Data > 0xF) return;
 
 		if (DataHelper::WriteBits(SavUtils::Sav->GetData(), Offs, First, Data)) {
+			S2CORE_STAT(Writes, 1);
+			S2CORE_STAT(WriteBytes, 1);
+
 			if (!SavUtils::Sav->GetChangesMade()) SavUtils::Sav->SetChangesMade(true);
+			SavUtils::Sav->MarkDirty(Offs, 1);
 		}
 	};
 
 
 	/*
-		Read a string from the SavBuffer.
+		Read a string from the SavBuffer, decoded with the character set of the SAV's Region.
 
 		const uint32_t Offs: The Offset from where to read from.
 		const uint32_t Length: The Length to read.
 	*/
 	const std::string SavUtils::ReadString(const uint32_t Offs, const uint32_t Length) {
-		if (!SavUtils::Sav || !SavUtils::Sav->GetValid()) return "";
+		S2CORE_STAT(Reads, 1);
+		S2CORE_STAT(ReadBytes, Length);
+
+		if (SavUtils::Pinned()) return DataHelper::ReadString(SavUtils::Pinned(), Offs, Length, SavUtils::Sav->GetRegion());
 
-		return DataHelper::ReadString(SavUtils::Sav->GetData(), Offs, Length);
+		if (!SavUtils::Sav || !SavUtils::Sav->GetValid()) return "";
+		return DataHelper::ReadString(SavUtils::Sav->GetData(), Offs, Length, SavUtils::Sav->GetRegion());
 	};
 	
 	/*
-		Write a string to the SavBuffer.
+		Write a string to the SavBuffer, encoded with the character set of the SAV's Region.
 
 		const uint32_t Offs: The offset from where to write to.
 		const uint32_t Length: The length to write.
 		const std::string &Str: The string to write.
 	*/
 	void SavUtils::WriteString(const uint32_t Offs, const uint32_t Length, const std::string &Str) {
-		if (!SavUtils::Sav || !SavUtils::Sav->GetValid()) return;
+		if (!SavUtils::Sav || !SavUtils::Sav->GetValid() || SavUtils::Sav->GetReadOnly()) return;
+
+		if (DataHelper::WriteString(SavUtils::Sav->GetData(), Offs, Length, Str, SavUtils::Sav->GetRegion())) {
+			S2CORE_STAT(Writes, 1);
+			S2CORE_STAT(WriteBytes, Length);
 
-		if (DataHelper::WriteString(SavUtils::Sav->GetData(), Offs, Length, Str)) {
 			if (!SavUtils::Sav->GetChangesMade()) SavUtils::Sav->SetChangesMade(true);
+			SavUtils::Sav->MarkDirty(Offs, Length);
 		}
 	};
 
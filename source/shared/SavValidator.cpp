@@ -0,0 +1,200 @@
+/*
+*   This file is part of Sim2Editor-CPPCore
+*   Copyright (C) 2020-2021 Sim2Team
+*
+*   This program is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Additional Terms 7.b and 7.c of GPLv3 apply to this file:
+*       * Requiring preservation of specified reasonable legal notices or
+*         author attributions in that material or in the Appropriate Legal
+*         Notices displayed by works containing it.
+*       * Prohibiting misrepresentation of the origin of that material,
+*         or requiring that modified versions of such material be marked in
+*         reasonable ways as different from the original version.
+*/
+
+#include "DataHelper.hpp"
+#include "Sav.hpp"
+#include "SavValidator.hpp"
+#include <algorithm>
+
+
+namespace S2Core {
+	/*
+		Return the path of something, that isn't a Field, like 'Slot1.Inventory' or 'Settings.Checksum'.
+
+		const SavSectionRef &Ref: The Section.
+		const char *Name: The Record or Checksum name.
+	*/
+	static std::string IssuePath(const SavSectionRef &Ref, const char *Name) {
+		std::string Res = SavLayout::SectionName(Ref.Section);
+		if (Ref.Section != SavSection::GBASettings) Res += std::to_string(Ref.Index);
+
+		return Res + "." + Name;
+	};
+
+
+	/*
+		Validate a single Section.
+
+		uint8_t *Buffer: The SavBuffer.
+		const SavSectionRef &Ref: The Section.
+		const bool Repair: If illegal values should be repaired.
+		SavReport &Report: Where to add the issues to.
+	*/
+	static void ValidateSection(uint8_t *Buffer, const SavSectionRef &Ref, const bool Repair, SavReport &Report) {
+		const uint8_t HouseItems = SavLayout::HouseItems(Buffer, Ref);
+		bool Changed = false;
+
+		/* Record counts (like 'HouseItemCount') are also plain Fields, but get reported as a Count issue only. */
+		std::vector<uint32_t> CountOffs;
+		for (const SavRecord &Rec : SavLayout::Records(Ref.Section)) {
+			if (Rec.CountOffs) CountOffs.push_back(Ref.Offs + Rec.CountOffs);
+		}
+
+		for (const SavRecord &Rec : SavLayout::Records(Ref.Section)) {
+			const uint8_t Count = SavLayout::RecordCount(Buffer, Ref, Rec);
+
+			if (Rec.CountOffs && Buffer[Ref.Offs + Rec.CountOffs] > Rec.Count) {
+				Report.Issues.push_back({ SavIssueKind::Count, IssuePath(Ref, Rec.Name),
+					Ref.Offs + Rec.CountOffs, Buffer[Ref.Offs + Rec.CountOffs], Rec.Count });
+			}
+
+			for (uint8_t Idx = 0; Idx < Count; Idx++) {
+				for (const SavField &Field : Rec.Fields) {
+					if (!SavLayout::Numeric(Field)) continue;
+					Report.Fields++;
+
+					const uint32_t Offs = SavLayout::FieldOffs(Ref, Rec, Field, Idx, HouseItems);
+					if (std::find(CountOffs.begin(), CountOffs.end(), Offs) != CountOffs.end()) continue;
+
+					const uint32_t V = SavLayout::Read(Buffer, Offs, Field, Idx);
+					if (SavLayout::Legal(Field, V)) continue;
+
+					SavIssue Issue = { SavIssueKind::Range, SavLayout::Path(Ref, Rec, Field, Idx), Offs, V, SavLayout::Clamp(Field, V) };
+
+					if (Repair && !Field.ReadOnly) {
+						SavLayout::Write(Buffer, Offs, Field, Issue.Expected, Idx);
+						if (Field.Mirror) Buffer[Ref.Offs + Field.Mirror] = (uint8_t)Issue.Expected;
+
+						Issue.Repaired = Changed = true;
+						Report.Repaired++;
+					}
+
+					Report.Issues.push_back(Issue);
+				}
+			}
+
+			/* Item counts. */
+			if (Rec.TallyOffs) {
+				uint8_t Amount = 0;
+				for (uint8_t Idx = 0; Idx < Rec.Count; Idx++) {
+					if (SavLayout::Read(Buffer, SavLayout::FieldOffs(Ref, Rec, Rec.Fields[0], Idx, HouseItems), Rec.Fields[0]) != Rec.EmptyID) Amount++;
+				}
+
+				if (Buffer[Ref.Offs + Rec.TallyOffs] != Amount) {
+					SavIssue Issue = { SavIssueKind::Count, IssuePath(Ref, Rec.Name),
+						Ref.Offs + Rec.TallyOffs, Buffer[Ref.Offs + Rec.TallyOffs], Amount };
+
+					if (Repair) {
+						Buffer[Ref.Offs + Rec.TallyOffs] = Amount;
+						Issue.Repaired = Changed = true;
+						Report.Repaired++;
+					}
+
+					Report.Issues.push_back(Issue);
+				}
+			}
+		}
+
+		/* Checksums. Repairs above change them, so fix them in that case no matter if they matched before. */
+		for (const SavChecksum &CHKS : SavLayout::Checksums(Ref.Section)) {
+			Report.Checksums++;
+			const uint16_t Stored = DataHelper::Read<uint16_t>(Buffer, Ref.Offs + CHKS.Offs);
+			const uint16_t Calced = SavLayout::CalcChecksum(Buffer, Ref, CHKS);
+			if (Stored == Calced && !Changed) continue;
+
+			if (Repair) {
+				DataHelper::Write<uint16_t>(Buffer, Ref.Offs + CHKS.Offs, Calced);
+				Changed = true; // The NDS Painting header Checksum covers the main Checksum.
+			}
+
+			if (Stored == Calced) continue;
+
+			Report.Issues.push_back({ SavIssueKind::Checksum, IssuePath(Ref, CHKS.Name),
+				Ref.Offs + CHKS.Offs, Stored, Calced, Repair });
+
+			if (Repair) Report.Repaired++;
+		}
+	};
+
+
+	/*
+		Validate a SAV.
+
+		uint8_t *Buffer: The SavBuffer.
+		const std::vector<SavSectionRef> &Refs: The Sections of the SAV.
+		const bool Repair: If illegal values should be repaired.
+	*/
+	static SavReport Validate(uint8_t *Buffer, const std::vector<SavSectionRef> &Refs, const bool Repair) {
+		SavReport Report;
+
+		for (const SavSectionRef &Ref : Refs) {
+			if (SavLayout::Used(Buffer, Ref)) ValidateSection(Buffer, Ref, Repair, Report);
+		}
+
+		return Report;
+	};
+
+
+	/*
+		Check a SAV without changing it.
+
+		const SAV &Sav: The SAV to check.
+	*/
+	SavReport SavValidator::Check(const SAV &Sav) {
+		if (!Sav.GetValid()) return { };
+
+		return Validate(Sav.GetData(), SavLayout::Sections(Sav), false);
+	};
+
+
+	/*
+		Check a SAV and repair all issues it can.
+
+		SAV &Sav: The SAV to check and repair. Read only SAVs only get checked.
+	*/
+	SavReport SavValidator::Repair(SAV &Sav) {
+		if (!Sav.GetValid()) return { };
+		if (Sav.GetReadOnly()) return SavValidator::Check(Sav);
+
+		const std::vector<SavSectionRef> Refs = SavLayout::Sections(Sav);
+		SavReport Report = Validate(Sav.GetData(), Refs, true);
+		if (!Report.Repaired) return Report;
+
+		/* Repairs are rare, so simply mark the whole Sections as dirty. */
+		for (const SavSectionRef &Ref : Refs) {
+			for (const SavIssue &Issue : Report.Issues) {
+				if (Issue.Repaired && Issue.Offs >= Ref.Offs && Issue.Offs < Ref.Offs + Ref.Size) {
+					Sav.MarkDirty(Ref.Offs, Ref.Size);
+					break;
+				}
+			}
+		}
+
+		Sav.SetChangesMade(true);
+
+		return Report;
+	};
+};
\ No newline at end of file
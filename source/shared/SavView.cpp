@@ -0,0 +1,115 @@
+/*
+*   This file is part of Sim2Editor-CPPCore
+*   Copyright (C) 2020-2021 Sim2Team
+*
+*   This program is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Additional Terms 7.b and 7.c of GPLv3 apply to this file:
+*       * Requiring preservation of specified reasonable legal notices or
+*         author attributions in that material or in the Appropriate Legal
+*         Notices displayed by works containing it.
+*       * Prohibiting misrepresentation of the origin of that material,
+*         or requiring that modified versions of such material be marked in
+*         reasonable ways as different from the original version.
+*/
+
+#include "Sav.hpp"
+#include "SavSnapshot.hpp"
+#include "SavUtils.hpp"
+#include "SavView.hpp"
+
+
+namespace S2Core {
+	/*
+		Open a read only view over SavUtils::Sav.
+
+		const uint32_t Offs: The start Offset of the view.
+		const uint32_t Size: The size of the view.
+	*/
+	SavView::SavView(const uint32_t Offs, const uint32_t Size) { this->Init(SavUtils::Sav.get(), Offs, Size); };
+
+	/*
+		Open a read only view over a SAV.
+
+		const SAV &Sav: The SAV.
+		const uint32_t Offs: The start Offset of the view.
+		const uint32_t Size: The size of the view.
+	*/
+	SavView::SavView(const SAV &Sav, const uint32_t Offs, const uint32_t Size) { this->Init(&Sav, Offs, Size); };
+
+	/*
+		Do all the checks once. On failure, the view stays invalid.
+
+		const SAV *Sav: The SAV.
+		const uint32_t Offs: The start Offset of the view.
+		const uint32_t Size: The size of the view.
+	*/
+	void SavView::Init(const SAV *Sav, const uint32_t Offs, const uint32_t Size) {
+		const uint8_t *Buffer = nullptr;
+		uint32_t BufferSize = 0;
+
+		if (SavSnapshot::Pinned() && SavSnapshot::PinnedOwner() == Sav) { // Only a pin of this SAV.
+			Buffer = SavSnapshot::Pinned();
+			BufferSize = SavSnapshot::PinnedSize();
+
+		} else if (Sav && Sav->GetValid()) {
+			Buffer = Sav->GetData();
+			BufferSize = Sav->GetSize();
+		}
+
+		if (!Buffer || Offs > BufferSize || Size > BufferSize - Offs) return;
+
+		this->Data = Buffer + Offs;
+		this->Offs = Offs;
+		this->Size = Size;
+	};
+
+
+	/*
+		Open a writable view over SavUtils::Sav.
+
+		const uint32_t Offs: The start Offset of the view.
+		const uint32_t Size: The size of the view.
+	*/
+	SavEditView::SavEditView(const uint32_t Offs, const uint32_t Size) { this->Init(SavUtils::Sav.get(), Offs, Size); };
+
+	/*
+		Open a writable view over a SAV.
+
+		SAV &Sav: The SAV.
+		const uint32_t Offs: The start Offset of the view.
+		const uint32_t Size: The size of the view.
+	*/
+	SavEditView::SavEditView(SAV &Sav, const uint32_t Offs, const uint32_t Size) { this->Init(&Sav, Offs, Size); };
+
+	/* Do all the checks once. On failure, the view stays invalid. */
+	void SavEditView::Init(SAV *Sav, const uint32_t Offs, const uint32_t Size) {
+		if (!Sav || !Sav->GetValid() || Sav->GetReadOnly() || !Sav->GetData()) return;
+		if (Offs > Sav->GetSize() || Size > Sav->GetSize() - Offs) return;
+
+		this->Sav = Sav;
+		this->Data = Sav->GetData() + Offs;
+		this->Offs = Offs;
+		this->Size = Size;
+	};
+
+	/* Apply ChangesMade and mark the range of the view dirty, if anything got written since the last Commit. */
+	void SavEditView::Commit() {
+		if (!this->Touched || !this->Sav) return;
+
+		if (!this->Sav->GetChangesMade()) this->Sav->SetChangesMade(true);
+		this->Sav->MarkDirty(this->Offs, this->Size);
+		this->Touched = false;
+	};
+};
\ No newline at end of file
@@ -0,0 +1,195 @@
+/*
+*   This file is part of Sim2Editor-CPPCore
+*   Copyright (C) 2020-2021 Sim2Team
+*
+*   This program is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Additional Terms 7.b and 7.c of GPLv3 apply to this file:
+*       * Requiring preservation of specified reasonable legal notices or
+*         author attributions in that material or in the Appropriate Legal
+*         Notices displayed by works containing it.
+*       * Prohibiting misrepresentation of the origin of that material,
+*         or requiring that modified versions of such material be marked in
+*         reasonable ways as different from the original version.
+*/
+
+#include "Sav.hpp"
+#include "SavWatcher.hpp"
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef __linux__
+	#include <sys/inotify.h>
+#endif
+
+
+namespace S2Core {
+	/*
+		Initialize the watcher. Nothing is watched until Start().
+
+		SAV &Sav: The SAV, which needs to be loaded from a file.
+	*/
+	SavWatcher::SavWatcher(SAV &Sav) : Sav(Sav) {
+		const std::string Path = this->Sav.GetPath();
+		const size_t Slash = Path.find_last_of('/');
+
+		this->Dir = (Slash == std::string::npos ? "." : (Slash == 0 ? "/" : Path.substr(0, Slash)));
+		this->Name = (Slash == std::string::npos ? Path : Path.substr(Slash + 1));
+	};
+
+
+	SavWatcher::~SavWatcher() { this->Stop(); };
+
+
+	/* Start watching. Returns false if the SAV has no SavFile, is read only or inotify is not available. */
+	bool SavWatcher::Start() {
+		#ifdef __linux__
+			if (this->FD != -1) return true;
+			if (!this->Sav.GetValid() || this->Sav.GetReadOnly() || this->Name == "") return false;
+
+			this->FD = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+			if (this->FD == -1) return false;
+
+			this->Watch = inotify_add_watch(this->FD, this->Dir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO); // Not IN_MODIFY, the writer may not be done yet.
+			if (this->Watch == -1) {
+				this->Stop();
+				return false;
+			}
+
+			return true;
+		#else
+			return false;
+		#endif
+	};
+
+
+	/* Stop watching. */
+	void SavWatcher::Stop() {
+		if (this->FD == -1) return;
+
+		close(this->FD); // Removes the watch as well.
+		this->FD = -1;
+		this->Watch = -1;
+	};
+
+
+	/*
+		Wait for an event and handle it.
+
+		const int Timeout: The timeout in milliseconds, -1 to wait forever.
+
+		Returns true, if there was an event.
+	*/
+	bool SavWatcher::Wait(const int Timeout) {
+		if (this->FD == -1) return false;
+
+		struct pollfd Poll = { this->FD, POLLIN, 0 };
+		return poll(&Poll, 1, Timeout) > 0 && (Poll.revents & POLLIN);
+	};
+
+
+	/*
+		Handle the pending inotify events and reload the SavFile, if it got written.
+
+		Returns what changed, empty if nothing did.
+	*/
+	SavChangeEvent SavWatcher::Check() {
+		bool Changed = false;
+
+		#ifdef __linux__
+			if (this->FD == -1) return { };
+
+			alignas(struct inotify_event) char Buffer[0x1000];
+			ssize_t Length;
+
+			while ((Length = read(this->FD, Buffer, sizeof(Buffer))) > 0) {
+				for (char *Ptr = Buffer; Ptr < Buffer + Length;) {
+					const struct inotify_event *Event = (const struct inotify_event *)Ptr;
+					if (Event->len && (Event->mask & (IN_CLOSE_WRITE | IN_MOVED_TO)) && this->Name == Event->name) Changed = true;
+
+					Ptr += sizeof(struct inotify_event) + Event->len;
+				}
+			}
+		#endif
+
+		return (Changed ? this->Reload() : SavChangeEvent());
+	};
+
+
+	/*
+		Compare the SavFile with the SavBuffer block by block and take over the changed blocks.
+
+		Blocks with unsaved local changes are not touched and reported as Conflicts instead.
+		Returns what changed.
+	*/
+	SavChangeEvent SavWatcher::Reload() {
+		SavChangeEvent Res;
+		if (!this->Sav.GetValid() || this->Sav.GetReadOnly()) return Res;
+
+		const int File = open(this->Sav.GetPath().c_str(), O_RDONLY);
+		if (File == -1) return Res; // In the middle of a rename, the next event comes.
+
+		struct stat Info;
+		if (fstat(File, &Info) != 0 || (uint64_t)Info.st_size != this->Sav.GetFileSize()) {
+			Res.Resized = true;
+			close(File);
+			return Res;
+		}
+
+		uint8_t Block[BlockSize];
+
+		for (uint32_t Offs = 0; Offs < this->Sav.GetFileSize(); Offs += this->BlockSize) {
+			const uint32_t Length = std::min(this->BlockSize, this->Sav.GetFileSize() - Offs);
+			if (pread(File, Block, Length, Offs) != (ssize_t)Length) break;
+
+			uint8_t *Current = this->Sav.GetFileData() + Offs;
+			if (!memcmp(Current, Block, Length)) continue;
+
+			/* Outside of the Sav data, like a container footer. */
+			if (Offs >= this->Sav.GetSize()) {
+				memcpy(Current, Block, Length);
+				continue;
+			}
+
+			const uint32_t Start = Offs, End = std::min(Offs + Length, this->Sav.GetSize());
+			if (this->Sav.Dirty(Start, End - Start)) {
+				Res.Conflicts.push_back({ Start, End - Start });
+				continue;
+			}
+
+			memcpy(Current, Block, Length);
+			Res.Ranges.push_back({ Start, End - Start });
+		}
+
+		close(File);
+		if (Res.Ranges.empty()) return Res;
+
+		/* Only the NDS Slot directory depends on the data, so refresh it only if the Slot area changed. */
+		if (this->Sav.GetType() == SavType::_NDS && Res.Ranges.front().first < 0x5000) this->Sav.ValidationCheck();
+		if (this->Sav.CurrentEpoch()) this->Sav.Publish(); // Readers pinning the SAV should see the new state.
+
+		for (const SavSectionRef &Ref : SavLayout::Sections(this->Sav)) {
+			for (const std::pair<uint32_t, uint32_t> &Range : Res.Ranges) {
+				if (Range.first < Ref.Offs + Ref.Size && Ref.Offs < Range.first + Range.second) {
+					Res.Sections.push_back(Ref);
+					break;
+				}
+			}
+		}
+
+		return Res;
+	};
+};
\ No newline at end of file
@@ -0,0 +1,246 @@
+/*
+*   This file is part of Sim2Editor-CPPCore
+*   Copyright (C) 2020-2021 Sim2Team
+*
+*   This program is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Additional Terms 7.b and 7.c of GPLv3 apply to this file:
+*       * Requiring preservation of specified reasonable legal notices or
+*         author attributions in that material or in the Appropriate Legal
+*         Notices displayed by works containing it.
+*       * Prohibiting misrepresentation of the origin of that material,
+*         or requiring that modified versions of such material be marked in
+*         reasonable ways as different from the original version.
+*/
+
+#include "Sav.hpp"
+#include "SavLayout.hpp"
+#include "SavStats.hpp"
+#include "SavTransfer.hpp"
+#include "SavWriter.hpp"
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+namespace S2Core {
+	/* Write a whole buffer at an offset, retrying on short writes. */
+	static bool WriteAt(const int FD, const uint8_t *Data, uint32_t Length, uint32_t Offs) {
+		while (Length > 0) {
+			const ssize_t Written = pwrite(FD, Data, Length, Offs);
+			if (Written <= 0) return false;
+			S2CORE_STAT(FileWriteBytes, Written);
+
+			Data += Written;
+			Offs += Written;
+			Length -= Written;
+		}
+
+		return true;
+	};
+
+
+	/* Read a whole buffer from an offset, retrying on short reads. */
+	static bool ReadAt(const int FD, uint8_t *Data, uint32_t Length, uint32_t Offs) {
+		while (Length > 0) {
+			const ssize_t Read = pread(FD, Data, Length, Offs);
+			if (Read <= 0) return false;
+			S2CORE_STAT(FileReadBytes, Read);
+
+			Data += Read;
+			Offs += Read;
+			Length -= Read;
+		}
+
+		return true;
+	};
+
+
+	/*
+		Rewrite the Sav data of the SavFile in place. Container footers and padding are left alone.
+
+		const SAV &Sav: The SAV.
+		uint32_t &Written: Where to store the amount of written bytes.
+	*/
+	static bool WriteInPlace(const SAV &Sav, uint32_t &Written) {
+		const int FD = open(Sav.GetPath().c_str(), O_WRONLY);
+		if (FD == -1) return false;
+
+		const bool Good = WriteAt(FD, Sav.GetData(), Sav.GetSize(), 0);
+		if (close(FD) != 0 || !Good) return false;
+
+		Written = Sav.GetSize();
+		return true;
+	};
+
+
+	/*
+		Write the SavFile through a temporary file, which gets renamed over the SavFile.
+
+		const SAV &Sav: The SAV.
+		uint32_t &Written: Where to store the amount of written bytes.
+	*/
+	static bool WriteAtomic(const SAV &Sav, uint32_t &Written) {
+		const std::string Tmp = Sav.GetPath() + ".tmp";
+
+		struct stat Info;
+		const mode_t Mode = (stat(Sav.GetPath().c_str(), &Info) == 0 ? (Info.st_mode & 0777) : 0666);
+
+		const int FD = open(Tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, Mode);
+		if (FD == -1) return false;
+
+		const bool Good = WriteAt(FD, Sav.GetFileData(), Sav.GetFileSize(), 0) && fsync(FD) == 0; // Keep footers and padding.
+		if (close(FD) != 0 || !Good || rename(Tmp.c_str(), Sav.GetPath().c_str()) != 0) {
+			unlink(Tmp.c_str());
+			return false;
+		}
+
+		/* Sync the directory as well, so the rename itself survives a crash. */
+		const size_t Slash = Sav.GetPath().find_last_of('/');
+		const std::string Dir = (Slash == std::string::npos ? "." : (Slash == 0 ? "/" : Sav.GetPath().substr(0, Slash)));
+
+		const int DirFD = open(Dir.c_str(), O_RDONLY);
+		if (DirFD != -1) {
+			fsync(DirFD);
+			close(DirFD);
+		}
+
+		Written = Sav.GetFileSize();
+		return true;
+	};
+
+
+	/*
+		Only write the blocks with dirty bytes, adjacent blocks in one go.
+
+		const SAV &Sav: The SAV.
+		uint32_t &Written: Where to store the amount of written bytes.
+	*/
+	static bool WriteMinimal(const SAV &Sav, uint32_t &Written) {
+		const std::vector<std::pair<uint32_t, uint32_t>> Ranges = Sav.DirtyRanges();
+		if (Ranges.empty()) return WriteInPlace(Sav, Written);
+
+		/* Grow the dirty ranges to whole blocks and merge those, that touch. */
+		std::vector<std::pair<uint32_t, uint32_t>> Blocks;
+		for (const std::pair<uint32_t, uint32_t> &Range : Ranges) {
+			const uint32_t Start = Range.first & ~(SavWriter::BlockSize - 1);
+			const uint32_t End = std::min(Sav.GetSize(), (Range.first + Range.second + SavWriter::BlockSize - 1) & ~(SavWriter::BlockSize - 1));
+
+			if (!Blocks.empty() && Blocks.back().second >= Start) Blocks.back().second = std::max(Blocks.back().second, End);
+			else Blocks.push_back({ Start, End });
+		}
+
+		const int FD = open(Sav.GetPath().c_str(), O_WRONLY);
+		if (FD == -1) return false;
+
+		uint32_t Total = 0;
+		bool Good = true;
+		for (const std::pair<uint32_t, uint32_t> &Block : Blocks) {
+			Good = WriteAt(FD, Sav.GetData() + Block.first, Block.second - Block.first, Block.first);
+			if (!Good) break;
+
+			Total += Block.second - Block.first;
+		}
+
+		#ifdef __linux__
+			if (Good) Good = (fdatasync(FD) == 0);
+		#else
+			if (Good) Good = (fsync(FD) == 0);
+		#endif
+
+		if (close(FD) != 0 || !Good) return false;
+
+		Written = Total;
+		return true;
+	};
+
+
+	/*
+		Save the edited NDS Slots to new physical Slots like the game does it, then write like Minimal.
+
+		SAV &Sav: The SAV.
+		uint32_t &Written: Where to store the amount of written bytes.
+
+		The physical Slot which got edited is read back from the SavFile, so it is the previous save again.
+		Each edited Slot therefore writes a single 0x1000 byte block.
+		Returns false without writing to the SavFile, if an edited Slot couldn't be rotated.
+	*/
+	static bool WriteRotate(SAV &Sav, uint32_t &Written) {
+		if (Sav.GetType() != SavType::_NDS) return WriteMinimal(Sav, Written);
+
+		const int FD = open(Sav.GetPath().c_str(), O_RDONLY);
+		if (FD == -1) return false;
+
+		bool Good = true;
+		for (uint8_t Slot = 0; Slot < 3; Slot++) {
+			const int8_t Physical = Sav.GetNDSSlot(Slot);
+			if (Physical == -1 || !Sav.Dirty(Physical * SavTransfer::SlotSize, SavTransfer::SlotSize)) continue;
+
+			/* If a Slot can't be rotated, writing it like Minimal would overwrite the previous save, so fail instead. */
+			uint8_t Previous[SavTransfer::SlotSize];
+			Good = ReadAt(FD, Previous, SavTransfer::SlotSize, Physical * SavTransfer::SlotSize) &&
+				SavTransfer::CopySlot(Sav, Slot, Sav, Slot);
+			if (!Good) break;
+
+			memcpy(Sav.GetData() + (Physical * SavTransfer::SlotSize), Previous, SavTransfer::SlotSize);
+			Sav.ClearDirty(Physical * SavTransfer::SlotSize, SavTransfer::SlotSize);
+		}
+
+		if (close(FD) != 0 || !Good) return false;
+		return WriteMinimal(Sav, Written);
+	};
+
+
+	/*
+		Write a SAV back to its SavFile.
+
+		SAV &Sav: The SAV, which needs to be loaded from a file.
+		const SavWriteMode Mode: How to write.
+		uint32_t &Written: Where to store the amount of written bytes.
+
+		Returns false, if writing failed. The SAV stays dirty in that case.
+	*/
+	bool SavWriter::Write(SAV &Sav, const SavWriteMode Mode, uint32_t &Written) {
+		Written = 0;
+		if (!Sav.GetValid() || Sav.GetPath() == "") return false;
+
+		SavLayout::FixDirtyChecksums(Sav);
+		bool Res = false;
+
+		switch(Mode) {
+			case SavWriteMode::InPlace:
+				Res = WriteInPlace(Sav, Written);
+				break;
+
+			case SavWriteMode::Atomic:
+				Res = WriteAtomic(Sav, Written);
+				break;
+
+			case SavWriteMode::Minimal:
+				Res = WriteMinimal(Sav, Written);
+				break;
+
+			case SavWriteMode::Rotate:
+				Res = WriteRotate(Sav, Written);
+				break;
+		}
+
+		if (Res) {
+			Sav.ClearDirty();
+			Sav.SetChangesMade(false);
+		}
+
+		return Res;
+	};
+};
\ No newline at end of file
@@ -0,0 +1,167 @@
+/*
+*   This file is part of Sim2Editor-CPPCore
+*   Copyright (C) 2020-2021 Sim2Team
+*
+*   This program is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Additional Terms 7.b and 7.c of GPLv3 apply to this file:
+*       * Requiring preservation of specified reasonable legal notices or
+*         author attributions in that material or in the Appropriate Legal
+*         Notices displayed by works containing it.
+*       * Prohibiting misrepresentation of the origin of that material,
+*         or requiring that modified versions of such material be marked in
+*         reasonable ways as different from the original version.
+*/
+
+#include "StringCodec.hpp"
+
+
+namespace S2Core {
+	/*
+		A byte -> code point table and its inverse.
+		Code points only come from two pages, U+00xx and U+<HighPage>xx, so the inverse is two byte tables. 0x0 means not mappable.
+		Bytes without a character get a code point of the private use page U+F7xx, so they survive a round trip as well.
+	*/
+	struct CodecTable {
+		uint16_t Decode[0x100] = { };
+		uint8_t Low[0x100] = { };
+		uint8_t High[0x100] = { };
+		uint8_t HighPage = 0x0;
+	};
+
+	static constexpr uint16_t RawPage = 0xF700;
+
+	static constexpr CodecTable MakeTable(const bool Jpn) {
+		CodecTable Table = { };
+		Table.HighPage = (Jpn ? 0xFF : 0x0);
+
+		for (uint16_t Byte = 0x1; Byte < 0x100; Byte++) {
+			uint16_t CP = Byte; // Latin-1 and ASCII map 1:1.
+
+			if (Jpn && Byte >= 0x80) {
+				if (Byte >= 0xA1 && Byte <= 0xDF) CP = 0xFF61 + (Byte - 0xA1); // Half-width katakana.
+				else CP = RawPage + Byte; // Unused by JIS X 0201.
+			}
+
+			Table.Decode[Byte] = CP;
+			if (CP < 0x100) Table.Low[CP] = (uint8_t)Byte;
+			else if ((CP >> 8) == Table.HighPage) Table.High[CP & 0xFF] = (uint8_t)Byte;
+		}
+
+		return Table;
+	};
+
+	static constexpr CodecTable IntTable = MakeTable(false);
+	static constexpr CodecTable JpnTable = MakeTable(true);
+
+	static const CodecTable &Table(const NDSSavRegion Region) { return (Region == NDSSavRegion::Jpn ? JpnTable : IntTable); };
+
+
+	/*
+		Decode a Sav string to UTF-8.
+
+		const uint8_t *Src: The Sav string.
+		const uint32_t Length: The maximum length of the Sav string, it ends earlier on 0x0.
+		char *Out: Where to write the UTF-8 string to. It does not get null terminated.
+		const size_t OutSize: The size of Out. MaxUTF8(Length) is always enough.
+		const NDSSavRegion Region: The Region, for the character set.
+
+		Returns the amount of bytes written to Out.
+	*/
+	size_t StringCodec::Decode(const uint8_t *Src, const uint32_t Length, char *Out, const size_t OutSize, const NDSSavRegion Region) {
+		if (!Src || !Out) return 0;
+
+		const CodecTable &Codec = Table(Region);
+		size_t Pos = 0;
+
+		for (uint32_t Idx = 0; Idx < Length && Src[Idx] != 0x0; Idx++) {
+			const uint16_t CP = Codec.Decode[Src[Idx]];
+
+			if (CP < 0x80) {
+				if (Pos + 1 > OutSize) break;
+				Out[Pos++] = (char)CP;
+
+			} else if (CP < 0x800) {
+				if (Pos + 2 > OutSize) break;
+				Out[Pos++] = (char)(0xC0 | (CP >> 6));
+				Out[Pos++] = (char)(0x80 | (CP & 0x3F));
+
+			} else {
+				if (Pos + 3 > OutSize) break;
+				Out[Pos++] = (char)(0xE0 | (CP >> 12));
+				Out[Pos++] = (char)(0x80 | ((CP >> 6) & 0x3F));
+				Out[Pos++] = (char)(0x80 | (CP & 0x3F));
+			}
+		}
+
+		return Pos;
+	};
+
+
+	/*
+		Encode an UTF-8 string to a Sav string.
+
+		const char *Str: The UTF-8 string.
+		const size_t StrLength: The length of Str in bytes.
+		uint8_t *Out: Where to write the Sav string to.
+		const uint32_t Length: The length of the Sav string. Everything after the last character is filled with 0x0.
+		const NDSSavRegion Region: The Region, for the character set.
+
+		Characters which don't exist in the character set are written as '?', U+F7xx from Decode() is written as the raw byte again.
+		Bytes which aren't valid UTF-8 are taken as Latin-1, so raw Sav bytes survive a round trip through std::string.
+
+		Returns the amount of characters written.
+	*/
+	uint32_t StringCodec::Encode(const char *Str, const size_t StrLength, uint8_t *Out, const uint32_t Length, const NDSSavRegion Region) {
+		if (!Out) return 0;
+
+		const CodecTable &Codec = Table(Region);
+		uint32_t Written = 0;
+		size_t Idx = 0;
+
+		while (Str && Idx < StrLength && Written < Length) {
+			const uint8_t C = (uint8_t)Str[Idx];
+			uint32_t CP = C;
+			uint8_t Need = 0;
+
+			if (C >= 0xC2 && C <= 0xDF) { Need = 1; CP = C & 0x1F; }
+			else if (C >= 0xE0 && C <= 0xEF) { Need = 2; CP = C & 0x0F; }
+			else if (C >= 0xF0 && C <= 0xF4) { Need = 3; CP = C & 0x07; }
+
+			uint8_t Got = 0;
+			while (Got < Need && Idx + 1 + Got < StrLength && ((uint8_t)Str[Idx + 1 + Got] & 0xC0) == 0x80) {
+				CP = (CP << 6) | ((uint8_t)Str[Idx + 1 + Got] & 0x3F);
+				Got++;
+			}
+
+			if (Got != Need) { // Not valid UTF-8, take the byte as is.
+				CP = C;
+				Got = 0;
+			}
+
+			Idx += 1 + Got;
+			if (CP == 0x0) break;
+
+			uint8_t Byte = 0x0;
+			if (CP < 0x100) Byte = Codec.Low[CP];
+			else if (CP < 0x10000 && Codec.HighPage && (CP >> 8) == Codec.HighPage) Byte = Codec.High[CP & 0xFF];
+			else if ((CP >> 8) == (RawPage >> 8) && Codec.Decode[CP & 0xFF] == CP) Byte = CP & 0xFF; // A raw byte from Decode().
+
+			Out[Written++] = (Byte ? Byte : '?');
+		}
+
+		if (Written < Length) memset(Out + Written, 0x0, Length - Written);
+		return Written;
+	};
+};
\ No newline at end of file